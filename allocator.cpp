@@ -0,0 +1,167 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <barrier>                      // std::barrier<>
+#include <memory>                       // std::unique_ptr<> and std::make_unique()
+#include <cstdlib>                      // malloc() and free()
+#include <cstring>                      // strrchr() and strncmp()
+#include <dlfcn.h>                      // dlsym() and dladdr()
+#include <gnu/libc-version.h>           // gnu_get_libc_version()
+#include "parcount.h"
+
+const int allocationBatch = 256;        // blocks each thread holds live in the batched kernels
+
+/*
+ * allocatorName will name the library that malloc() resolves to, which is whatever
+ * LD_PRELOAD put ahead of the C library
+ *
+ * Input Arguments:
+ * None
+ *
+ * Return Values:
+ * File name of the library providing malloc(), with its version for glibc
+ */
+static std::string allocatorName() {
+    Dl_info info;
+    void* symbol = dlsym(RTLD_DEFAULT, "malloc");
+    if (!symbol || !dladdr(symbol, &info) || !info.dli_fname) {
+        return "unknown";
+    }
+    const char* slash = strrchr(info.dli_fname, '/');
+    std::string name = slash ? slash + 1 : info.dli_fname;
+    if (strncmp(name.c_str(), "libc.so", 7) == 0) {
+        name = std::string("glibc-") + gnu_get_libc_version();
+    }
+    return name;
+}
+
+/*
+ * randomSize will draw an allocation size in [1, maxSize] whose power of two size class
+ * is uniform, so small blocks are as common as large ones class for class
+ */
+static std::size_t randomSize(uint64_t& state, std::size_t maxSize) {
+    int classes = 1;
+    while ((std::size_t(16) << (classes - 1)) <= maxSize) {
+        ++classes;
+    }
+    uint64_t random = nextRandom(state);
+    std::size_t limit = std::size_t(8) << (random % classes);
+    return 1 + (random >> 32) % (limit < maxSize ? limit : maxSize);
+}
+
+/*
+ * timeAllocations will sweep the thread count up to t, running kernel on every thread
+ * with its own random state, and print one line of results per thread count.  Each
+ * kernel makes i allocations per thread and frees all of them
+ *
+ * Input Arguments:
+ * functionName - name printed for kernel
+ * kernel - function run by every thread, given its index, the number of threads and
+ *          its random state
+ * arguments - parsed command line arguments
+ * allocator - name of the allocator printed in the results
+ * prepare - function run before each thread count, given the number of threads
+ *
+ * Return Values:
+ * None
+ */
+template <typename Kernel, typename Prepare>
+static void timeAllocations(const char* functionName, Kernel kernel, Arguments& arguments,
+                            const std::string& allocator, Prepare prepare) {
+    double singleThreadSeconds = 0;
+    for(int t : doublingThreadCounts(arguments.t)) {
+        prepare(t);
+        double seconds = runThreads(t, [&](int iterator) {
+            uint64_t state = mixHash(iterator + 1) | 1;
+            kernel(iterator, t, state);
+        });
+        if (t == 1) {
+            singleThreadSeconds = seconds;
+        }
+        uint64_t operations = 2 * static_cast<uint64_t>(t) * arguments.i;
+        std::cout << functionName << "\t" << operations << "\t" << t << "\t" << allocator << "\t" << arguments.k
+                  << "\t" << operations/seconds << "\t" << scalingEfficiency(singleThreadSeconds, seconds) << "\t"
+                  << seconds << "\n";
+    }
+}
+
+/*
+ * runAllocatorBenchmark will have 1, 2, 4, ... up to t threads each make i allocations
+ * of mixed sizes up to k bytes, touching and freeing every one, in four sequences:
+ *
+ * mallocFreePairs - malloc() then free() straight away
+ * newDeletePairs - new[] then delete[] straight away
+ * mallocFreeBatches - malloc() a batch of blocks, then free() them oldest first
+ * crossThreadFree - malloc() a batch of blocks, then free() the batch the next thread
+ *                   allocated, with a barrier between the two halves of every round
+ *
+ * The final counter value counts allocations and frees.  Scaling is the throughput over
+ * that of one thread times the number of threads, 1 being perfect scaling.  Run under
+ * LD_PRELOAD to compare allocators; the library providing malloc() is named in the
+ * results
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runAllocatorBenchmark(Arguments& arguments) {
+    int i = arguments.i;
+    std::size_t maxSize = arguments.k > 0 ? arguments.k : 1;
+    std::string allocator = allocatorName();
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tAllocator\tMax Size\tOperations/Second\t"
+              << "Scaling\tSeconds\n";
+
+    timeAllocations("mallocFreePairs", [&](int, int, uint64_t& state) {
+        for(int allocation = 0; allocation < i; ++allocation) {
+            char* block = static_cast<char*>(malloc(randomSize(state, maxSize)));
+            block[0] = 1;
+            free(block);
+        }
+    }, arguments, allocator, [](int) {});
+
+    timeAllocations("newDeletePairs", [&](int, int, uint64_t& state) {
+        for(int allocation = 0; allocation < i; ++allocation) {
+            char* block = new char[randomSize(state, maxSize)];
+            block[0] = 1;
+            delete[] block;
+        }
+    }, arguments, allocator, [](int) {});
+
+    timeAllocations("mallocFreeBatches", [&](int, int, uint64_t& state) {
+        char* batch[allocationBatch];
+        for(int allocation = 0; allocation < i; allocation += allocationBatch) {
+            int batchSize = i - allocation < allocationBatch ? i - allocation : allocationBatch;
+            for(int block = 0; block < batchSize; ++block) {
+                batch[block] = static_cast<char*>(malloc(randomSize(state, maxSize)));
+                batch[block][0] = 1;
+            }
+            for(int block = 0; block < batchSize; ++block) {
+                free(batch[block]);
+            }
+        }
+    }, arguments, allocator, [](int) {});
+
+    std::vector<std::vector<char*>> outboxes;
+    std::unique_ptr<std::barrier<>> roundBarrier;
+    timeAllocations("crossThreadFree", [&](int iterator, int t, uint64_t& state) {
+        std::vector<char*>& myOutbox = outboxes[iterator];
+        std::vector<char*>& inbox = outboxes[(iterator + 1) % t];
+        for(int allocation = 0; allocation < i; allocation += allocationBatch) {
+            int batchSize = i - allocation < allocationBatch ? i - allocation : allocationBatch;
+            for(int block = 0; block < batchSize; ++block) {
+                myOutbox[block] = static_cast<char*>(malloc(randomSize(state, maxSize)));
+                myOutbox[block][0] = 1;
+            }
+            roundBarrier->arrive_and_wait();
+            for(int block = 0; block < batchSize; ++block) {
+                free(inbox[block]);
+            }
+            roundBarrier->arrive_and_wait();
+        }
+    }, arguments, allocator, [&](int t) {
+        outboxes.assign(t, std::vector<char*>(allocationBatch));
+        roundBarrier = std::make_unique<std::barrier<>>(t);
+    });
+}
@@ -0,0 +1,155 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <thread>                       // std::thread
+#include <future>                       // std::async(), std::future<> and std::promise<>
+#include <system_error>                 // std::system_error
+#include "parcount.h"
+
+/*
+ * taskSizes will split t*i increments into tasks of at most g increments
+ *
+ * Input Arguments:
+ * t - number of threads
+ * i - increments per thread
+ * g - increments per task, treated as 1 if smaller
+ *
+ * Return Values:
+ * Number of increments for each task
+ */
+static std::vector<int> taskSizes(int t, int i, int g) {
+    std::vector<int> sizes;
+    g = g < 1 ? 1 : g;
+    long long remaining = static_cast<long long>(t) * i;
+    while (remaining > 0) {
+        int size = remaining < g ? static_cast<int>(remaining) : g;
+        sizes.push_back(size);
+        remaining -= size;
+    }
+    return sizes;
+}
+
+/*
+ * printAsyncResult will print one line of results for a task kernel.  Overhead per task
+ * is the time beyond the threadVector baseline divided by the number of tasks
+ */
+static void printAsyncResult(const char* functionName, long long counter, int t, std::size_t tasks,
+                             double seconds, double baselineSeconds) {
+    std::cout << functionName << "\t" << counter << "\t" << t << "\t" << tasks << "\t"
+              << counter/(seconds*1000) << "\t" << seconds*1e6/tasks << "\t"
+              << (seconds - baselineSeconds)*1e6/tasks << "\t" << seconds << "\n";
+}
+
+/*
+ * runAsyncBenchmark will perform t*i increments as tasks of g increments launched with
+ * std::async() under both launch policies and with std::promise<> on a std::thread,
+ * and compare them with t threads in a threadVector each doing i increments, as main()
+ * does.  Tasks are launched in batches of t, and each batch is collected before the
+ * next is launched, so no more than t task threads are alive at once.  Every timing
+ * includes creating and joining the threads or tasks.  A kernel whose threads cannot
+ * be created is reported and its row skipped
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runAsyncBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+    std::vector<int> sizes = taskSizes(t, i, arguments.g);
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tTasks\tIncrements/Millisecond\t"
+              << "Microseconds/Task\tOverhead/Task (us)\tSeconds\n";
+
+    /*
+     * t threads each increment a local counter i times and store it in localCounters,
+     * which is summed after all threads are joined
+     */
+    std::vector<int> localCounters(t);
+    std::vector<std::thread> threadVector;
+    int64_t t1 = nowNanoseconds();
+    for(int iterator = 0; iterator < t; ++iterator) {
+        threadVector.push_back(std::thread([&localCounters, iterator, i]() {
+            localCounters[iterator] = incrementiTimesReturnCount(i);
+        }));
+    }
+    for(auto& thread : threadVector) {
+        thread.join();
+    }
+    long long counter = 0;
+    for(int localCounter : localCounters) {
+        counter += localCounter;
+    }
+    double baselineSeconds = (nowNanoseconds() - t1) / 1e9;
+    printAsyncResult("threadVector", counter, t, t, baselineSeconds, baselineSeconds);
+
+    /*
+     * Each task is launched with std::async() and its count collected through the
+     * returned std::future<>.  std::launch::async runs every task on a new thread,
+     * std::launch::deferred runs it on the calling thread inside get()
+     */
+    const std::launch policies[] = {std::launch::async, std::launch::deferred};
+    const char* policyNames[] = {"asyncLaunchAsync", "asyncLaunchDeferred"};
+    for(int policy = 0; policy < 2; ++policy) {
+        try {
+            std::vector<std::future<int>> futures;
+            futures.reserve(t);
+            counter = 0;
+            t1 = nowNanoseconds();
+            for(std::size_t batch = 0; batch < sizes.size(); batch += t) {
+                for(std::size_t task = batch; task < sizes.size() && task < batch + t; ++task) {
+                    futures.push_back(std::async(policies[policy], incrementiTimesReturnCount, sizes[task]));
+                }
+                for(auto& future : futures) {
+                    counter += future.get();
+                }
+                futures.clear();
+            }
+            double seconds = (nowNanoseconds() - t1) / 1e9;
+            printAsyncResult(policyNames[policy], counter, t, sizes.size(), seconds, baselineSeconds);
+        }
+        catch (const std::system_error& error) {
+            std::cerr << policyNames[policy] << ": " << error.what() << "\n";
+        }
+    }
+
+    /*
+     * Each task runs on a std::thread and completes a std::promise<> whose std::future<>
+     * the launching thread waits on before joining the thread
+     */
+    std::vector<std::future<int>> futures;
+    std::vector<std::thread> promiseThreads;
+    futures.reserve(t);
+    promiseThreads.reserve(t);
+    counter = 0;
+    t1 = nowNanoseconds();
+    try {
+        for(std::size_t batch = 0; batch < sizes.size(); batch += t) {
+            for(std::size_t task = batch; task < sizes.size() && task < batch + t; ++task) {
+                std::promise<int> promise;
+                futures.push_back(promise.get_future());
+                promiseThreads.push_back(std::thread([size = sizes[task]](std::promise<int> taskPromise) {
+                    taskPromise.set_value(incrementiTimesReturnCount(size));
+                }, std::move(promise)));
+            }
+            for(auto& future : futures) {
+                counter += future.get();
+            }
+            for(auto& thread : promiseThreads) {
+                thread.join();
+            }
+            futures.clear();
+            promiseThreads.clear();
+        }
+    }
+    catch (const std::system_error& error) {
+        for(auto& thread : promiseThreads) {
+            thread.join();
+        }
+        std::cerr << "promiseThread: " << error.what() << "\n";
+        return;
+    }
+    double seconds = (nowNanoseconds() - t1) / 1e9;
+    printAsyncResult("promiseThread", counter, t, sizes.size(), seconds, baselineSeconds);
+}
@@ -0,0 +1,212 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <atomic>                       // std::atomic<int>
+#include <barrier>                      // std::barrier<>
+#include <algorithm>                    // std::max()
+#include "parcount.h"
+
+/*
+ * PaddedEpisode is an episode counter on its own cache line so that flags belonging
+ * to different threads never share a line
+ */
+struct alignas(cacheLineSize) PaddedEpisode {
+    std::atomic<int> episode{0};
+};
+
+/*
+ * CentralizedBarrier is a sense-reversing counter barrier.  The last thread to arrive
+ * resets the count and flips the shared sense, releasing every thread spinning on it
+ */
+class CentralizedBarrier {
+public:
+    explicit CentralizedBarrier(int t) : threadCount(t), localSense(t) {
+        remaining = t;
+    }
+
+    void arriveAndWait(int iterator) {
+        bool mySense = !localSense[iterator].sense;
+        localSense[iterator].sense = mySense;
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            remaining.store(threadCount, std::memory_order_relaxed);
+            sense.store(mySense, std::memory_order_release);
+        }
+        else {
+            spinUntil([&]() { return sense.load(std::memory_order_acquire) == mySense; });
+        }
+    }
+
+private:
+    struct alignas(cacheLineSize) LocalSense {
+        bool sense = false;
+    };
+    int threadCount;
+    alignas(cacheLineSize) std::atomic<int> remaining;
+    alignas(cacheLineSize) std::atomic<bool> sense{false};
+    std::vector<LocalSense> localSense;
+};
+
+/*
+ * DisseminationBarrier runs ceil(log2(t)) rounds.  In round r thread n signals thread
+ * (n + 2^r) mod t and waits to be signalled by thread (n - 2^r) mod t.  Flags count
+ * episodes so they never need to be reset
+ */
+class DisseminationBarrier {
+public:
+    explicit DisseminationBarrier(int t) : threadCount(t), rounds(0), episodes(t) {
+        while ((1 << rounds) < t) {
+            ++rounds;
+        }
+        flags = std::vector<PaddedEpisode>(t * rounds);
+    }
+
+    void arriveAndWait(int iterator) {
+        int episode = ++episodes[iterator].episode;
+        for(int round = 0; round < rounds; ++round) {
+            int partner = (iterator + (1 << round)) % threadCount;
+            flags[partner * rounds + round].episode.fetch_add(1, std::memory_order_release);
+            std::atomic<int>& myFlag = flags[iterator * rounds + round].episode;
+            spinUntil([&]() { return myFlag.load(std::memory_order_acquire) >= episode; });
+        }
+    }
+
+private:
+    int threadCount;
+    int rounds;
+    std::vector<PaddedEpisode> flags;
+    std::vector<PaddedEpisode> episodes;
+};
+
+/*
+ * TournamentBarrier pairs threads in a binary tree.  In round r the thread whose index
+ * is a multiple of 2^(r+1) waits for its opponent n + 2^r to arrive, and the opponent
+ * drops out to wait for a wakeup.  Thread 0 wins the tournament and wakes its
+ * opponents, who wake theirs, back down the tree
+ */
+class TournamentBarrier {
+public:
+    explicit TournamentBarrier(int t) : threadCount(t), arrived(t), released(t), episodes(t) {}
+
+    void arriveAndWait(int iterator) {
+        int episode = ++episodes[iterator].episode;
+        int round = 0;
+        while ((1 << round) < threadCount) {
+            if (iterator % (1 << (round + 1)) != 0) {
+                arrived[iterator].episode.store(episode, std::memory_order_release);
+                std::atomic<int>& myRelease = released[iterator].episode;
+                spinUntil([&]() { return myRelease.load(std::memory_order_acquire) >= episode; });
+                break;
+            }
+            int opponent = iterator + (1 << round);
+            if (opponent < threadCount) {
+                std::atomic<int>& opponentArrived = arrived[opponent].episode;
+                spinUntil([&]() { return opponentArrived.load(std::memory_order_acquire) >= episode; });
+            }
+            ++round;
+        }
+        // Wake every opponent beaten on the way up, latest round first
+        for(int wonRound = round - 1; wonRound >= 0; --wonRound) {
+            int opponent = iterator + (1 << wonRound);
+            if (opponent < threadCount) {
+                released[opponent].episode.store(episode, std::memory_order_release);
+            }
+        }
+    }
+
+private:
+    int threadCount;
+    std::vector<PaddedEpisode> arrived;
+    std::vector<PaddedEpisode> released;
+    std::vector<PaddedEpisode> episodes;
+};
+
+/*
+ * StandardBarrier adapts std::barrier<> to the arriveAndWait interface
+ */
+class StandardBarrier {
+public:
+    explicit StandardBarrier(int t) : barrier(t) {}
+
+    void arriveAndWait(int) {
+        barrier.arrive_and_wait();
+    }
+
+private:
+    std::barrier<> barrier;
+};
+
+/*
+ * timeBarrier will have t threads pass through barrier i times, recording when each
+ * thread arrives at and leaves every episode, and print episodes per second and the
+ * spread of release latency.  Release latency is the time from the last thread
+ * arriving at an episode to a given thread leaving it
+ *
+ * Input Arguments:
+ * functionName - name printed in the results
+ * barrier - reference to the barrier under test
+ * t - number of threads
+ * i - number of barrier episodes
+ *
+ * Return Values:
+ * None
+ */
+template <typename Barrier>
+void timeBarrier(const char* functionName, Barrier& barrier, int t, int i) {
+    std::vector<std::vector<int64_t>> arrivals(t, std::vector<int64_t>(i));
+    std::vector<std::vector<int64_t>> departures(t, std::vector<int64_t>(i));
+
+    double seconds = runThreads(t, [&](int iterator) {
+        std::vector<int64_t>& myArrivals = arrivals[iterator];
+        std::vector<int64_t>& myDepartures = departures[iterator];
+        for(int episode = 0; episode < i; ++episode) {
+            myArrivals[episode] = nowNanoseconds();
+            barrier.arriveAndWait(iterator);
+            myDepartures[episode] = nowNanoseconds();
+        }
+    });
+
+    std::vector<double> releaseLatencies;
+    releaseLatencies.reserve(static_cast<std::size_t>(t) * i);
+    for(int episode = 0; episode < i; ++episode) {
+        int64_t lastArrival = 0;
+        for(int iterator = 0; iterator < t; ++iterator) {
+            lastArrival = std::max(lastArrival, arrivals[iterator][episode]);
+        }
+        for(int iterator = 0; iterator < t; ++iterator) {
+            releaseLatencies.push_back((departures[iterator][episode] - lastArrival) / 1000.0);
+        }
+    }
+
+    std::cout << functionName << "\t" << t << "\t" << i << "\t" << i/seconds << "\t"
+              << percentile(releaseLatencies, 0.5) << "\t" << percentile(releaseLatencies, 0.99) << "\t"
+              << percentile(releaseLatencies, 1.0) << "\t" << seconds << "\n";
+}
+
+/*
+ * runBarrierBenchmark will have t threads pass through i episodes of a centralized,
+ * dissemination, tournament and std::barrier<> barrier
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runBarrierBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+
+    std::cout << "Function Name\tThreads\tEpisodes\tEpisodes/Second\tMedian Release Latency (us)\t"
+              << "P99 Release Latency (us)\tMax Release Latency (us)\tSeconds\n";
+
+    CentralizedBarrier centralizedBarrier(t);
+    timeBarrier("centralizedBarrier", centralizedBarrier, t, i);
+
+    DisseminationBarrier disseminationBarrier(t);
+    timeBarrier("disseminationBarrier", disseminationBarrier, t, i);
+
+    TournamentBarrier tournamentBarrier(t);
+    timeBarrier("tournamentBarrier", tournamentBarrier, t, i);
+
+    StandardBarrier standardBarrier(t);
+    timeBarrier("standardBarrier", standardBarrier, t, i);
+}
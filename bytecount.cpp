@@ -0,0 +1,238 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <immintrin.h>                  // SSE2, AVX2 and AVX-512 intrinsics
+#include "parcount.h"
+
+/*
+ * Each counting function below comes in one version per instruction set.  The vector
+ * versions compare a whole register of bytes at once, turn the comparison into a bit
+ * mask and add its population count, then leave the tail shorter than a register to the
+ * scalar version.  Functions are compiled for their instruction set with a target
+ * attribute, so the binary runs anywhere and bestByteCounter() picks at runtime
+ */
+
+template <BytePredicateKind Kind>
+static uint64_t countBytesScalarKind(const uint8_t* data, std::size_t size, uint8_t low, uint8_t high) {
+    uint64_t count = 0;
+    uint8_t span = high - low;
+    for(std::size_t index = 0; index < size; ++index) {
+        uint8_t byte = data[index];
+        if constexpr (Kind == byteEquals) {
+            count += byte == low;
+        }
+        else if constexpr (Kind == byteInRange) {
+            count += static_cast<uint8_t>(byte - low) <= span;
+        }
+        else {
+            count += (byte & low) != 0;
+        }
+    }
+    return count;
+}
+
+template <BytePredicateKind Kind>
+__attribute__((target("sse2,popcnt")))
+static uint64_t countBytesSse2Kind(const uint8_t* data, std::size_t size, uint8_t low, uint8_t high) {
+    const __m128i lowVector = _mm_set1_epi8(static_cast<char>(low));
+    const __m128i spanVector = _mm_set1_epi8(static_cast<char>(high - low));
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t count = 0;
+    std::size_t index = 0;
+    for(; index + 16 <= size; index += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        if constexpr (Kind == byteEquals) {
+            count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, lowVector)));
+        }
+        else if constexpr (Kind == byteInRange) {
+            // byte - low wraps below low, so one unsigned comparison checks both ends
+            __m128i offset = _mm_sub_epi8(bytes, lowVector);
+            count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(offset, spanVector), offset)));
+        }
+        else {
+            count += 16 - __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, lowVector), zero)));
+        }
+    }
+    return count + countBytesScalarKind<Kind>(data + index, size - index, low, high);
+}
+
+template <BytePredicateKind Kind>
+__attribute__((target("avx2,popcnt")))
+static uint64_t countBytesAvx2Kind(const uint8_t* data, std::size_t size, uint8_t low, uint8_t high) {
+    const __m256i lowVector = _mm256_set1_epi8(static_cast<char>(low));
+    const __m256i spanVector = _mm256_set1_epi8(static_cast<char>(high - low));
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t count = 0;
+    std::size_t index = 0;
+    for(; index + 32 <= size; index += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+        __m256i matches;
+        if constexpr (Kind == byteEquals) {
+            matches = _mm256_cmpeq_epi8(bytes, lowVector);
+        }
+        else if constexpr (Kind == byteInRange) {
+            __m256i offset = _mm256_sub_epi8(bytes, lowVector);
+            matches = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, spanVector), offset);
+        }
+        else {
+            matches = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, lowVector), zero);
+        }
+        unsigned bits = __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(matches)));
+        count += Kind == byteMasked ? 32 - bits : bits;
+    }
+    return count + countBytesScalarKind<Kind>(data + index, size - index, low, high);
+}
+
+template <BytePredicateKind Kind>
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static uint64_t countBytesAvx512Kind(const uint8_t* data, std::size_t size, uint8_t low, uint8_t high) {
+    const __m512i lowVector = _mm512_set1_epi8(static_cast<char>(low));
+    const __m512i spanVector = _mm512_set1_epi8(static_cast<char>(high - low));
+    uint64_t count = 0;
+    std::size_t index = 0;
+    for(; index + 64 <= size; index += 64) {
+        __m512i bytes = _mm512_loadu_si512(data + index);
+        __mmask64 matches;
+        if constexpr (Kind == byteEquals) {
+            matches = _mm512_cmpeq_epi8_mask(bytes, lowVector);
+        }
+        else if constexpr (Kind == byteInRange) {
+            matches = _mm512_cmple_epu8_mask(_mm512_sub_epi8(bytes, lowVector), spanVector);
+        }
+        else {
+            matches = _mm512_test_epi8_mask(bytes, lowVector);
+        }
+        count += __builtin_popcountll(matches);
+    }
+    return count + countBytesScalarKind<Kind>(data + index, size - index, low, high);
+}
+
+/*
+ * countBytes<Isa> will count the bytes of data[0, size) matching predicate
+ *
+ * Input Arguments:
+ * data - pointer to the first byte to examine
+ * size - number of bytes to examine
+ * predicate - reference to the predicate to match
+ *
+ * Return Values:
+ * Number of matching bytes
+ */
+#define DEFINE_COUNT_BYTES(Isa)                                                                  \
+    static uint64_t countBytes##Isa(const uint8_t* data, std::size_t size, const BytePredicate& predicate) { \
+        switch (predicate.kind) {                                                                \
+        case byteEquals:                                                                         \
+            return countBytes##Isa##Kind<byteEquals>(data, size, predicate.low, predicate.high); \
+        case byteInRange:                                                                        \
+            return countBytes##Isa##Kind<byteInRange>(data, size, predicate.low, predicate.high); \
+        default:                                                                                 \
+            return countBytes##Isa##Kind<byteMasked>(data, size, predicate.low, predicate.high); \
+        }                                                                                        \
+    }
+
+DEFINE_COUNT_BYTES(Scalar)
+DEFINE_COUNT_BYTES(Sse2)
+DEFINE_COUNT_BYTES(Avx2)
+DEFINE_COUNT_BYTES(Avx512)
+
+/*
+ * supportedByteCounters will list the byte counting functions the running processor
+ * supports, as reported by CPUID, from the scalar fallback up to the widest
+ *
+ * Input Arguments:
+ * None
+ *
+ * Return Values:
+ * Supported byte counters, narrowest first
+ */
+std::vector<ByteCounter> supportedByteCounters() {
+    std::vector<ByteCounter> counters;
+    counters.push_back(ByteCounter{"scalar", countBytesScalar});
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2") && __builtin_cpu_supports("popcnt")) {
+        counters.push_back(ByteCounter{"sse2", countBytesSse2});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        counters.push_back(ByteCounter{"avx2", countBytesAvx2});
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        counters.push_back(ByteCounter{"avx512", countBytesAvx512});
+    }
+    return counters;
+}
+
+/*
+ * bestByteCounter will return the widest byte counting function the processor supports
+ */
+ByteCounter bestByteCounter() {
+    return supportedByteCounters().back();
+}
+
+/*
+ * countBytesInParallel will split data[0, size) into t contiguous ranges and count the
+ * bytes matching predicate in each range on its own thread
+ *
+ * Input Arguments:
+ * counter - byte counting function each thread uses
+ * data - pointer to the first byte
+ * size - number of bytes
+ * predicate - reference to the predicate to match
+ * t - number of threads
+ * seconds - reference set to the time taken
+ *
+ * Return Values:
+ * Number of matching bytes
+ */
+uint64_t countBytesInParallel(const ByteCounter& counter, const uint8_t* data, std::size_t size,
+                              const BytePredicate& predicate, int t, double& seconds) {
+    std::vector<PaddedCount> counts(t);
+    seconds = runThreads(t, [&](int iterator) {
+        std::size_t begin = sliceBegin(size, t, iterator);
+        std::size_t end = sliceBegin(size, t, iterator + 1);
+        counts[iterator].count = counter.count(data + begin, end - begin, predicate);
+    });
+    uint64_t total = 0;
+    for(auto& count : counts) {
+        total += count.count;
+    }
+    return total;
+}
+
+/*
+ * runBufferCountBenchmark will fill an s MiB buffer with pseudorandom bytes and count
+ * the bytes equal to '*', in the range ['0', '9'], and with the high bit set, split
+ * across t threads, with every instruction set the processor supports
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runBufferCountBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    std::size_t size = static_cast<std::size_t>(arguments.s) << 20;
+
+    std::vector<uint8_t> buffer(size);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for(std::size_t index = 0; index < size; ++index) {
+        buffer[index] = static_cast<uint8_t>(nextRandom(state) >> 56);
+    }
+
+    const BytePredicate predicates[] = {
+        {byteEquals, '*', '*'},
+        {byteInRange, '0', '9'},
+        {byteMasked, 0x80, 0x80},
+    };
+    const char* predicateNames[] = {"equals", "range", "mask"};
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tInstruction Set\tPredicate\tBytes\tGB/Second\tSeconds\n";
+    for(const ByteCounter& counter : supportedByteCounters()) {
+        for(int predicate = 0; predicate < 3; ++predicate) {
+            double seconds;
+            uint64_t total = countBytesInParallel(counter, buffer.data(), size, predicates[predicate], t, seconds);
+            std::cout << "countBytes\t" << total << "\t" << t << "\t" << counter.name << "\t"
+                      << predicateNames[predicate] << "\t" << size << "\t" << size/seconds/1e9 << "\t"
+                      << seconds << "\n";
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#include <iostream>                     // std::cout
+#include <deque>                        // std::deque<>
+#include <mutex>                        // std::mutex and std::unique_lock<>
+#include <condition_variable>           // std::condition_variable
+#include <atomic>                       // std::atomic<long long>
+#include "parcount.h"
+
+const std::size_t bufferCapacity = 64;
+
+/*
+ * HandoffBuffer is a bounded queue of items behind one std::mutex, with one
+ * std::condition_variable for consumers waiting on an empty buffer and one for
+ * producers waiting on a full buffer.  Every return from wait() is counted as a
+ * wakeup, and as a useless wakeup if the waiter has to wait again
+ */
+class HandoffBuffer {
+public:
+    HandoffBuffer(bool notifyAll, bool notifyInsideLock, long long totalItems)
+        : notifyAll(notifyAll), notifyInsideLock(notifyInsideLock), itemsLeft(totalItems) {}
+
+    void produce(int item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (items.size() == bufferCapacity) {
+            notFull.wait(lock);
+            countWakeup(items.size() == bufferCapacity);
+        }
+        items.push_back(item);
+        notify(notEmpty, lock);
+    }
+
+    /*
+     * consume will take one item from the buffer, waiting while it is empty
+     *
+     * Return Values:
+     * false once every item has been consumed, true otherwise
+     */
+    bool consume(long long& sum) {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (items.empty() && itemsLeft > 0) {
+            notEmpty.wait(lock);
+            countWakeup(items.empty() && itemsLeft > 0);
+        }
+        if (itemsLeft == 0) {
+            return false;
+        }
+        sum += items.front();
+        items.pop_front();
+        if (--itemsLeft == 0) {
+            // Release every consumer still waiting so it can see there is nothing left
+            notEmpty.notify_all();
+        }
+        notify(notFull, lock);
+        return true;
+    }
+
+    long long wakeupCount() const {
+        return wakeups;
+    }
+
+    long long uselessWakeupCount() const {
+        return uselessWakeups;
+    }
+
+private:
+    void countWakeup(bool useless) {
+        ++wakeups;
+        if (useless) {
+            ++uselessWakeups;
+        }
+    }
+
+    void notify(std::condition_variable& cv, std::unique_lock<std::mutex>& lock) {
+        if (!notifyInsideLock) {
+            lock.unlock();
+        }
+        if (notifyAll) {
+            cv.notify_all();
+        }
+        else {
+            cv.notify_one();
+        }
+    }
+
+    bool notifyAll;
+    bool notifyInsideLock;
+    std::mutex mtx;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<int> items;
+    long long itemsLeft;
+    long long wakeups = 0;             // only changed with mtx held
+    long long uselessWakeups = 0;
+};
+
+/*
+ * timeHandoff will have t producers each push i items through a HandoffBuffer to t
+ * consumers, and print item throughput and the number of wakeups.  The final counter
+ * value is the sum of consumed items and will be i*t
+ *
+ * Input Arguments:
+ * functionName - name printed in the results
+ * notifyAll - notify_all() instead of notify_one() after each push and pop
+ * notifyInsideLock - notify while holding the mutex instead of after releasing it
+ * t - number of producers and of consumers
+ * i - items per producer
+ *
+ * Return Values:
+ * None
+ */
+static void timeHandoff(const char* functionName, bool notifyAll, bool notifyInsideLock, int t, int i) {
+    HandoffBuffer buffer(notifyAll, notifyInsideLock, static_cast<long long>(t) * i);
+    std::atomic<long long> counter{0};
+
+    double seconds = runThreads(2 * t, [&](int iterator) {
+        if (iterator < t) {
+            for(int item = 0; item < i; ++item) {
+                buffer.produce(1);
+            }
+        }
+        else {
+            long long sum = 0;
+            while (buffer.consume(sum));
+            counter.fetch_add(sum);
+        }
+    });
+
+    std::cout << functionName << "\t" << counter << "\t" << t << "\t" << t << "\t" << counter/(seconds*1000) << "\t"
+              << buffer.wakeupCount() << "\t" << buffer.uselessWakeupCount() << "\t" << seconds << "\n";
+}
+
+/*
+ * runCondVarBenchmark will pass i*t items from t producers to t consumers through a
+ * bounded buffer protected by a std::mutex and two std::condition_variables, notifying
+ * with notify_one() and notify_all(), inside and outside the lock
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runCondVarBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+
+    std::cout << "Function Name\tFinal Counter Value\tProducers\tConsumers\tItems/Millisecond\t"
+              << "Wakeups\tUseless Wakeups\tSeconds\n";
+
+    timeHandoff("notifyOneInsideLock", false, true, t, i);
+    timeHandoff("notifyOneOutsideLock", false, false, t, i);
+    timeHandoff("notifyAllInsideLock", true, true, t, i);
+    timeHandoff("notifyAllOutsideLock", true, false, t, i);
+}
@@ -0,0 +1,277 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <deque>                        // std::deque<>
+#include <thread>                       // std::thread and std::this_thread::yield()
+#include <mutex>                        // std::mutex and std::lock_guard<>
+#include <atomic>                       // std::atomic<int>
+#include <algorithm>                    // std::min() and std::max()
+#include <exception>                    // std::terminate()
+#include <coroutine>                    // std::coroutine_handle<> and std::suspend_always
+#include "parcount.h"
+
+/*
+ * CoroutineExecutor resumes suspended coroutines on a fixed set of worker threads that
+ * share one run queue
+ */
+class CoroutineExecutor {
+public:
+    explicit CoroutineExecutor(int threads) {
+        for(int worker = 0; worker < threads; ++worker) {
+            workers.push_back(std::thread(&CoroutineExecutor::workerLoop, this));
+        }
+    }
+
+    ~CoroutineExecutor() {
+        stopping = true;
+        for(auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void schedule(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(mtx);
+        runQueue.push_back(handle);
+    }
+
+private:
+    bool pop(std::coroutine_handle<>& handle) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (runQueue.empty()) {
+            return false;
+        }
+        handle = runQueue.front();
+        runQueue.pop_front();
+        return true;
+    }
+
+    void workerLoop() {
+        std::coroutine_handle<> handle;
+        int idleCounter = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (pop(handle)) {
+                handle.resume();
+                idleCounter = 0;
+            }
+            else if (++idleCounter % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::mutex mtx;
+    std::deque<std::coroutine_handle<>> runQueue;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping{false};
+};
+
+/*
+ * Reschedule suspends the awaiting coroutine and puts it on the back of the executor's
+ * run queue, letting the other coroutines run first
+ */
+struct Reschedule {
+    CoroutineExecutor& executor;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle) const {
+        executor.schedule(handle);
+    }
+    void await_resume() const noexcept {}
+};
+
+/*
+ * CounterCoroutine is the return type of incrementiTimesCoroutine.  The coroutine starts
+ * suspended and stays suspended at its end, so its owner reads the count and destroys
+ * it.  Reaching the end decrements the remaining counter handed to the coroutine, only
+ * once it has suspended, so the owner never destroys a running frame
+ */
+struct CounterCoroutine {
+    struct promise_type {
+        promise_type(CoroutineExecutor&, int, int, std::atomic<int>& remainingCoroutines)
+            : remaining(remainingCoroutines) {}
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+            void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                handle.promise().remaining.fetch_sub(1, std::memory_order_release);
+            }
+            void await_resume() const noexcept {}
+        };
+
+        CounterCoroutine get_return_object() {
+            return CounterCoroutine{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        FinalAwaiter final_suspend() noexcept {
+            return {};
+        }
+        void return_value(int localCounter) {
+            count = localCounter;
+        }
+        void unhandled_exception() {
+            std::terminate();
+        }
+
+        std::atomic<int>& remaining;
+        int count = 0;
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/*
+ * incrementiTimesCoroutine will run the command '++localCounter' i times, suspending
+ * onto the back of the executor's run queue after every g increments
+ *
+ * Input Arguments:
+ * executor - reference to the executor that resumes the coroutine
+ * i - the number of times to increment localCounter
+ * g - increments between suspensions
+ * remainingCoroutines - reference to a counter decremented once the coroutine finishes,
+ *                       read only by the promise constructor
+ *
+ * Return Values:
+ * The final value of localCounter, through the promise
+ */
+CounterCoroutine incrementiTimesCoroutine(CoroutineExecutor& executor, int i, int g,
+                                          [[maybe_unused]] std::atomic<int>& remainingCoroutines) {
+    int localCounter = 0;
+    for(int incrementCounter = 1; incrementCounter <= i; ++incrementCounter) {
+        ++localCounter;
+        if (incrementCounter % g == 0) {
+            co_await Reschedule{executor};
+        }
+    }
+    co_return localCounter;
+}
+
+/*
+ * SuspendingCoroutine is a coroutine its caller resumes directly until it is done
+ */
+struct SuspendingCoroutine {
+    struct promise_type {
+        SuspendingCoroutine get_return_object() {
+            return SuspendingCoroutine{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/*
+ * suspendiTimes will suspend i times and then finish
+ */
+SuspendingCoroutine suspendiTimes(int i) {
+    for(int suspendCounter = 0; suspendCounter < i; ++suspendCounter) {
+        co_await std::suspend_always{};
+    }
+}
+
+/*
+ * printCoroutineResult will print one line of results for a coroutine kernel
+ */
+static void printCoroutineResult(const char* functionName, long long counter, int threads, int coroutines,
+                                 long long suspensions, double seconds) {
+    std::cout << functionName << "\t" << counter << "\t" << threads << "\t" << coroutines << "\t"
+              << suspensions << "\t" << counter/(seconds*1000) << "\t"
+              << (suspensions > 0 ? seconds*1e9/suspensions : 0) << "\t" << seconds << "\n";
+}
+
+/*
+ * runCoroutineBenchmark will have t coroutines each increment a local counter i times,
+ * suspending every g increments, on an executor with one thread per available core (at
+ * most t), and compare them with t threads doing the same work with and without
+ * yielding at the same points.  The raw cost of resuming and suspending a coroutine on
+ * a single thread is measured first
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runCoroutineBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+    int g = arguments.g < 1 ? 1 : arguments.g;
+    long long suspensions = static_cast<long long>(t) * (i / g);
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tCoroutines\tSuspensions\t"
+              << "Increments/Millisecond\tNanoseconds/Suspension\tSeconds\n";
+
+    SuspendingCoroutine suspending = suspendiTimes(i);
+    int64_t t1 = nowNanoseconds();
+    while (!suspending.handle.done()) {
+        suspending.handle.resume();
+    }
+    double seconds = (nowNanoseconds() - t1) / 1e9;
+    suspending.handle.destroy();
+    printCoroutineResult("coroutineResumeSuspend", 0, 1, 1, i, seconds);
+
+    int executorThreads = std::min<int>(t, std::max<std::size_t>(allowedCores().size(), 1));
+    {
+        CoroutineExecutor executor(executorThreads);
+        std::atomic<int> remainingCoroutines{t};
+        std::vector<CounterCoroutine> coroutines;
+        for(int iterator = 0; iterator < t; ++iterator) {
+            coroutines.push_back(incrementiTimesCoroutine(executor, i, g, remainingCoroutines));
+        }
+        t1 = nowNanoseconds();
+        for(auto& coroutine : coroutines) {
+            executor.schedule(coroutine.handle);
+        }
+        spinUntil([&]() { return remainingCoroutines.load(std::memory_order_acquire) == 0; });
+        seconds = (nowNanoseconds() - t1) / 1e9;
+        long long counter = 0;
+        for(auto& coroutine : coroutines) {
+            counter += coroutine.handle.promise().count;
+            coroutine.handle.destroy();
+        }
+        printCoroutineResult("coroutineExecutor", counter, executorThreads, t, suspensions, seconds);
+    }
+
+    /*
+     * t threads each increment a local counter i times, as in the threadVector kernels,
+     * with no suspension points and then yielding where the coroutines suspend
+     */
+    std::vector<int> localCounters(t);
+    seconds = runThreads(t, [&](int iterator) {
+        localCounters[iterator] = incrementiTimesReturnCount(i);
+    });
+    long long counter = 0;
+    for(int localCounter : localCounters) {
+        counter += localCounter;
+    }
+    printCoroutineResult("threadPerWorker", counter, t, 0, 0, seconds);
+
+    seconds = runThreads(t, [&](int iterator) {
+        int localCounter = 0;
+        for(int incrementCounter = 1; incrementCounter <= i; ++incrementCounter) {
+            ++localCounter;
+            if (incrementCounter % g == 0) {
+                std::this_thread::yield();
+            }
+        }
+        localCounters[iterator] = localCounter;
+    });
+    counter = 0;
+    for(int localCounter : localCounters) {
+        counter += localCounter;
+    }
+    printCoroutineResult("threadPerWorkerYield", counter, t, 0, suspensions, seconds);
+}
@@ -0,0 +1,165 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <atomic>                       // std::atomic<uint64_t> and fetch_add()
+#include <algorithm>                    // std::partial_sort() and std::min()
+#include "parcount.h"
+
+/*
+ * Sketches have cmsDepth rows of cmsWidth cells.  The width is deliberately small so
+ * that with more than a few thousand keys the estimates collide and overcount
+ */
+const int cmsDepth = 4;
+const std::size_t cmsWidth = 1024;
+const std::size_t cmsCells = cmsDepth * cmsWidth;
+
+/*
+ * cmsColumn will return the cell of row that key updates, hashing key with a seed of its
+ * own for every row.  The seeds are nonzero because mixHash(0) is 0, which would put
+ * key 0, the heaviest Zipf key, in column 0 of every row
+ */
+const uint64_t cmsRowSeeds[cmsDepth] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+                                        0xD6E8FEB86659FD93ULL};
+
+static inline std::size_t cmsColumn(uint32_t key, int row) {
+    return mixHash(key ^ cmsRowSeeds[row]) & (cmsWidth - 1);
+}
+
+/*
+ * cmsEstimate will return the smallest of key's cells across the rows of a sketch whose
+ * row r starts at rows[r]
+ */
+template <typename Cell>
+static uint64_t cmsEstimate(Cell* const* rows, uint32_t key) {
+    uint64_t estimate = UINT64_MAX;
+    for(int row = 0; row < cmsDepth; ++row) {
+        estimate = std::min<uint64_t>(estimate, rows[row][cmsColumn(key, row)]);
+    }
+    return estimate;
+}
+
+/*
+ * printCountMinResult will print one line of results for a count-min kernel.  The final
+ * counter value is the sum of the first row, which is the number of updates.  The errors
+ * are the mean and largest overestimates of the heavy hitters relative to their exact
+ * counts
+ */
+template <typename Cell>
+static void printCountMinResult(const char* functionName, Cell* const* rows, int t, std::size_t n, uint32_t k,
+                                const std::vector<uint32_t>& heavyHitters, const std::vector<uint64_t>& exact,
+                                double seconds) {
+    uint64_t total = 0;
+    for(std::size_t column = 0; column < cmsWidth; ++column) {
+        total += rows[0][column];
+    }
+    double meanError = 0;
+    double maxError = 0;
+    for(uint32_t key : heavyHitters) {
+        double error = static_cast<double>(cmsEstimate(rows, key) - exact[key]) / exact[key];
+        meanError += error / heavyHitters.size();
+        maxError = std::max(maxError, error);
+    }
+    std::cout << functionName << "\t" << total << "\t" << t << "\t" << n << "\t" << k << "\t"
+              << n/(seconds*1000) << "\t" << meanError << "\t" << maxError << "\t" << seconds << "\n";
+}
+
+/*
+ * runCountMinBenchmark will count the frequencies of t*i Zipf distributed keys drawn
+ * from k values with a count-min sketch and t threads three ways:
+ *
+ * sharedAtomicCells - every thread fetch_adds into one shared sketch
+ * privateSketches - every thread counts its slice into its own sketch, summed cell by
+ *                   cell once all are joined
+ * paddedRowSharding - every row is owned by one thread and followed by a cache line of
+ *                     padding.  The owner reads the whole stream and updates its rows
+ *                     with plain adds, so there is neither sharing nor a merge, but
+ *                     threads beyond the number of rows have nothing to do
+ *
+ * Merging is included in the time.  Accuracy is reported over the ten most frequent keys,
+ * whose exact counts are computed untimed
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runCountMinBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    std::size_t n = static_cast<std::size_t>(t) * arguments.i;
+    uint32_t k = arguments.k > 0 ? arguments.k : 1;
+    std::vector<uint32_t> input = generateZipfInput(n, k, 1.0);
+
+    std::vector<uint64_t> exact(k);
+    for(uint32_t key : input) {
+        ++exact[key];
+    }
+    std::vector<uint32_t> heavyHitters(k);
+    for(uint32_t key = 0; key < k; ++key) {
+        heavyHitters[key] = key;
+    }
+    std::size_t heavyHitterCount = std::min<std::size_t>(10, k);
+    std::partial_sort(heavyHitters.begin(), heavyHitters.begin() + heavyHitterCount, heavyHitters.end(),
+                      [&](uint32_t a, uint32_t b) { return exact[a] > exact[b]; });
+    heavyHitters.resize(heavyHitterCount);
+    while (!heavyHitters.empty() && exact[heavyHitters.back()] == 0) {
+        heavyHitters.pop_back();
+    }
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tElements\tKeys\tUpdates/Millisecond\t"
+              << "Heavy Hitter Mean Error\tHeavy Hitter Max Error\tSeconds\n";
+
+    std::vector<std::atomic<uint64_t>> sharedCells(cmsCells);
+    double seconds = runThreads(t, [&](int iterator) {
+        std::size_t end = sliceBegin(n, t, iterator + 1);
+        for(std::size_t index = sliceBegin(n, t, iterator); index < end; ++index) {
+            for(int row = 0; row < cmsDepth; ++row) {
+                sharedCells[row * cmsWidth + cmsColumn(input[index], row)].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+    std::atomic<uint64_t>* sharedRows[cmsDepth];
+    for(int row = 0; row < cmsDepth; ++row) {
+        sharedRows[row] = &sharedCells[row * cmsWidth];
+    }
+    printCountMinResult("sharedAtomicCells", sharedRows, t, n, k, heavyHitters, exact, seconds);
+
+    std::vector<std::vector<uint64_t>> privateSketches(t, std::vector<uint64_t>(cmsCells));
+    std::vector<uint64_t> mergedCells(cmsCells);
+    seconds = runThreads(t, [&](int iterator) {
+        uint64_t* mySketch = privateSketches[iterator].data();
+        std::size_t end = sliceBegin(n, t, iterator + 1);
+        for(std::size_t index = sliceBegin(n, t, iterator); index < end; ++index) {
+            for(int row = 0; row < cmsDepth; ++row) {
+                ++mySketch[row * cmsWidth + cmsColumn(input[index], row)];
+            }
+        }
+    });
+    int64_t t1 = nowNanoseconds();
+    for(auto& mySketch : privateSketches) {
+        for(std::size_t cell = 0; cell < cmsCells; ++cell) {
+            mergedCells[cell] += mySketch[cell];
+        }
+    }
+    seconds += (nowNanoseconds() - t1) / 1e9;
+    uint64_t* mergedRows[cmsDepth];
+    for(int row = 0; row < cmsDepth; ++row) {
+        mergedRows[row] = &mergedCells[row * cmsWidth];
+    }
+    printCountMinResult("privateSketches", mergedRows, t, n, k, heavyHitters, exact, seconds);
+
+    const std::size_t rowPadding = cacheLineSize / sizeof(uint64_t);
+    std::vector<std::vector<uint64_t>> paddedRows(cmsDepth, std::vector<uint64_t>(cmsWidth + rowPadding));
+    seconds = runThreads(t, [&](int iterator) {
+        for(int row = iterator; row < cmsDepth; row += t) {
+            uint64_t* myRow = paddedRows[row].data();
+            for(uint32_t key : input) {
+                ++myRow[cmsColumn(key, row)];
+            }
+        }
+    });
+    uint64_t* shardedRows[cmsDepth];
+    for(int row = 0; row < cmsDepth; ++row) {
+        shardedRows[row] = paddedRows[row].data();
+    }
+    printCountMinResult("paddedRowSharding", shardedRows, t, n, k, heavyHitters, exact, seconds);
+}
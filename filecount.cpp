@@ -0,0 +1,143 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <algorithm>                    // std::max()
+#include <cstring>                      // memchr() and strerror()
+#include <cerrno>                       // errno
+#include <fcntl.h>                      // open()
+#include <unistd.h>                     // close()
+#include <sys/mman.h>                   // mmap(), madvise() and munmap()
+#include <sys/stat.h>                   // fstat()
+#include "parcount.h"
+
+/*
+ * recordAlignedSlices will split data[0, size) into t contiguous slices, moving every
+ * boundary after the split point forward to just past the next delimiter so no record
+ * straddles two slices.  A slice may be empty if a record is longer than size/t
+ *
+ * Input Arguments:
+ * data - pointer to the first byte
+ * size - number of bytes
+ * t - number of slices
+ * delimiter - byte that ends every record
+ *
+ * Return Values:
+ * t+1 boundaries; slice n is [boundaries[n], boundaries[n+1])
+ */
+std::vector<std::size_t> recordAlignedSlices(const uint8_t* data, std::size_t size, int t, uint8_t delimiter) {
+    std::vector<std::size_t> boundaries(t + 1);
+    boundaries[0] = 0;
+    for(int iterator = 1; iterator < t; ++iterator) {
+        std::size_t boundary = std::max(sliceBegin(size, t, iterator), boundaries[iterator - 1]);
+        const void* found = boundary < size ? memchr(data + boundary, delimiter, size - boundary) : nullptr;
+        boundaries[iterator] = found ? static_cast<const uint8_t*>(found) - data + 1 : size;
+    }
+    boundaries[t] = size;
+    return boundaries;
+}
+
+/*
+ * MappedFile will map the whole file at path read-only, hinting that it will be read
+ * once front to back.  error describes the failure if the file could not be mapped
+ */
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = strerror(errno);
+        return;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        error = strerror(errno);
+        close(fd);
+        return;
+    }
+    size = status.st_size;
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            error = strerror(errno);
+            size = 0;
+        }
+        else {
+            data = static_cast<const uint8_t*>(mapping);
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            madvise(mapping, size, MADV_WILLNEED);
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+}
+
+/*
+ * countMappedFile will map the file at path and count its delimiter bytes across t
+ * threads, each scanning a record aligned slice with counter
+ *
+ * Input Arguments:
+ * path - path of the file to count
+ * t - number of threads
+ * delimiter - byte to count
+ * counter - byte counting function each thread uses
+ * bytes - reference set to the size of the file
+ * error - reference set to a description of the failure, if any
+ *
+ * Return Values:
+ * Number of delimiter bytes, or 0 if the file could not be mapped
+ */
+uint64_t countMappedFile(const std::string& path, int t, uint8_t delimiter, const ByteCounter& counter,
+                         std::size_t& bytes, std::string& error) {
+    MappedFile file(path);
+    bytes = file.size;
+    error = file.error;
+    if (!error.empty()) {
+        return 0;
+    }
+    BytePredicate predicate = {byteEquals, delimiter, delimiter};
+    std::vector<std::size_t> boundaries = recordAlignedSlices(file.data, file.size, t, delimiter);
+    std::vector<PaddedCount> counts(t);
+    runThreads(t, [&](int iterator) {
+        std::size_t begin = boundaries[iterator];
+        counts[iterator].count = counter.count(file.data + begin, boundaries[iterator + 1] - begin, predicate);
+    });
+    uint64_t total = 0;
+    for(auto& count : counts) {
+        total += count.count;
+    }
+    return total;
+}
+
+/*
+ * runFileCountBenchmark will map the file named by --file and count its delimiter bytes
+ * (newlines unless -d is given) across t threads, each scanning a record aligned slice,
+ * once with every instruction set the processor supports.  Every run maps the file
+ * afresh so its page faults are part of the time
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runFileCountBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tInstruction Set\tBytes\tGB/Second\tSeconds\n";
+    for(const ByteCounter& counter : supportedByteCounters()) {
+        std::size_t bytes;
+        std::string error;
+        int64_t t1 = nowNanoseconds();
+        uint64_t total = countMappedFile(arguments.file, t, arguments.delimiter, counter, bytes, error);
+        double seconds = (nowNanoseconds() - t1) / 1e9;
+        if (!error.empty()) {
+            std::cerr << arguments.file << ": " << error << "\n";
+            return;
+        }
+
+        std::cout << "countFileDelimiters\t" << total << "\t" << t << "\t" << counter.name << "\t" << bytes
+                  << "\t" << bytes/seconds/1e9 << "\t" << seconds << "\n";
+    }
+}
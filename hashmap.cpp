@@ -0,0 +1,206 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <mutex>                        // std::mutex and std::lock_guard<>
+#include <unordered_map>                // std::unordered_map<>
+#include <atomic>                       // std::atomic<uint64_t>, compare_exchange_strong() and fetch_add()
+#include "parcount.h"
+
+/*
+ * LockFreeCounterMap is a fixed capacity open addressing hash map from nonzero keys
+ * to counts.  A slot is claimed by compare-and-swapping its key from 0, after which
+ * its count is only ever updated with fetch_add, so no thread ever blocks another.
+ * Slots are never removed
+ */
+class LockFreeCounterMap {
+public:
+    explicit LockFreeCounterMap(std::size_t minimumCapacity) {
+        capacity = 1;
+        while (capacity < minimumCapacity) {
+            capacity <<= 1;
+        }
+        keys = std::vector<std::atomic<uint64_t>>(capacity);
+        values = std::vector<std::atomic<uint64_t>>(capacity);
+        for(std::size_t slot = 0; slot < capacity; ++slot) {
+            keys[slot].store(0, std::memory_order_relaxed);
+            values[slot].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * increment will add 1 to the count of key, claiming a slot for key with linear
+     * probing if it is not yet present
+     *
+     * Input Arguments:
+     * key - nonzero key to increment
+     *
+     * Return Values:
+     * false if key was not present and the map is full, true otherwise
+     */
+    bool increment(uint64_t key) {
+        std::size_t mask = capacity - 1;
+        std::size_t slot = mixHash(key) & mask;
+        for(std::size_t probe = 0; probe < capacity; ++probe) {
+            uint64_t slotKey = keys[slot].load(std::memory_order_acquire);
+            if (slotKey == 0) {
+                uint64_t expected = 0;
+                if (keys[slot].compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+                    slotKey = key;
+                }
+                else {
+                    slotKey = expected;
+                }
+            }
+            if (slotKey == key) {
+                values[slot].fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return false;
+    }
+
+    /*
+     * total will return the sum of every count in the map.  It is only exact once all
+     * writers have finished
+     */
+    uint64_t total() const {
+        uint64_t sum = 0;
+        for(std::size_t slot = 0; slot < capacity; ++slot) {
+            sum += values[slot].load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    std::size_t capacity;
+    std::vector<std::atomic<uint64_t>> keys;
+    std::vector<std::atomic<uint64_t>> values;
+};
+
+/*
+ * StripedCounterMap splits the key space over stripeCount std::unordered_map<>s, each
+ * protected by its own std::mutex, so threads only contend when their keys share a stripe
+ */
+class StripedCounterMap {
+public:
+    static const std::size_t stripeCount = 64;
+
+    void increment(uint64_t key) {
+        Stripe& stripe = stripes[mixHash(key) % stripeCount];
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        ++stripe.counts[key];
+    }
+
+    uint64_t total() {
+        uint64_t sum = 0;
+        for(auto& stripe : stripes) {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            for(auto& keyCount : stripe.counts) {
+                sum += keyCount.second;
+            }
+        }
+        return sum;
+    }
+
+private:
+    struct Stripe {
+        std::mutex mtx;
+        std::unordered_map<uint64_t, uint64_t> counts;
+    };
+    Stripe stripes[stripeCount];
+};
+
+/*
+ * SingleMutexCounterMap is one std::unordered_map<> behind one std::mutex
+ */
+class SingleMutexCounterMap {
+public:
+    void increment(uint64_t key) {
+        std::lock_guard<std::mutex> lock(mtx);
+        ++counts[key];
+    }
+
+    uint64_t total() {
+        uint64_t sum = 0;
+        std::lock_guard<std::mutex> lock(mtx);
+        for(auto& keyCount : counts) {
+            sum += keyCount.second;
+        }
+        return sum;
+    }
+
+private:
+    std::mutex mtx;
+    std::unordered_map<uint64_t, uint64_t> counts;
+};
+
+/*
+ * incrementKeysiTimes will increment i pseudorandom keys in [1, k] in counterMap.
+ * Each thread seeds its own generator from its index so runs are repeatable
+ *
+ * Input Arguments:
+ * counterMap - reference to the map to increment
+ * iterator - index of the calling thread
+ * i - number of keys to increment
+ * k - number of distinct keys
+ *
+ * Return Values:
+ * None
+ */
+template <typename CounterMap>
+void incrementKeysiTimes(CounterMap& counterMap, int iterator, int i, int k) {
+    uint64_t state = mixHash(iterator + 1) | 1;
+    for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
+        counterMap.increment(nextRandom(state) % k + 1);
+    }
+}
+
+/*
+ * printHashMapResult will print one line of results for a counter map kernel
+ */
+static void printHashMapResult(const char* functionName, uint64_t total, Arguments& arguments, double seconds) {
+    std::cout << functionName << "\t" << total << "\t" << arguments.t << "\t" << arguments.k << "\t"
+              << total/(seconds*1000) << "\t" << seconds << "\n";
+}
+
+/*
+ * runHashMapBenchmark will have t threads each increment i pseudorandom keys out of k
+ * distinct keys in a lock-free open addressing map, a lock striped map, and a single
+ * mutex std::unordered_map<>.  The final counter value of each map will be i*t
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runHashMapBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+    int k = arguments.k;
+    if (k < 1) {
+        std::cerr << "Mode hashmap needs at least one key: -k " << k << "\n";
+        return;
+    }
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tKeys\tIncrements/Millisecond\tSeconds\n";
+
+    // Twice as many slots as keys keeps probe sequences short
+    LockFreeCounterMap lockFreeMap(2 * static_cast<std::size_t>(k));
+    double seconds = runThreads(t, [&](int iterator) {
+        incrementKeysiTimes(lockFreeMap, iterator, i, k);
+    });
+    printHashMapResult("lockFreeCounterMap", lockFreeMap.total(), arguments, seconds);
+
+    StripedCounterMap stripedMap;
+    seconds = runThreads(t, [&](int iterator) {
+        incrementKeysiTimes(stripedMap, iterator, i, k);
+    });
+    printHashMapResult("stripedCounterMap", stripedMap.total(), arguments, seconds);
+
+    SingleMutexCounterMap singleMutexMap;
+    seconds = runThreads(t, [&](int iterator) {
+        incrementKeysiTimes(singleMutexMap, iterator, i, k);
+    });
+    printHashMapResult("singleMutexCounterMap", singleMutexMap.total(), arguments, seconds);
+}
@@ -0,0 +1,160 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <atomic>                       // std::atomic<uint64_t> and fetch_add()
+#include <algorithm>                    // std::upper_bound() and std::fill()
+#include <cmath>                        // std::pow()
+#include "parcount.h"
+
+/*
+ * PaddedBin is a histogram bin on its own cache line
+ */
+struct alignas(cacheLineSize) PaddedBin {
+    std::atomic<uint64_t> count{0};
+};
+
+/*
+ * generateZipfInput will draw n bin indices in [0, B) whose frequencies follow a Zipf
+ * distribution, bin b being drawn in proportion to 1/(b+1)^skew.  A skew of 0 is uniform
+ *
+ * Input Arguments:
+ * n - number of indices to draw
+ * B - number of bins
+ * skew - Zipf exponent
+ *
+ * Return Values:
+ * The drawn bin indices
+ */
+std::vector<uint32_t> generateZipfInput(std::size_t n, uint32_t B, double skew) {
+    std::vector<double> cumulative(B);
+    double total = 0;
+    for(uint32_t bin = 0; bin < B; ++bin) {
+        total += 1 / std::pow(bin + 1.0, skew);
+        cumulative[bin] = total;
+    }
+    std::vector<uint32_t> input(n);
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    for(std::size_t index = 0; index < n; ++index) {
+        double draw = (nextRandom(state) >> 11) * (total / 9007199254740992.0);
+        uint32_t bin = std::upper_bound(cumulative.begin(), cumulative.end(), draw) - cumulative.begin();
+        input[index] = bin < B ? bin : B - 1;
+    }
+    return input;
+}
+
+/*
+ * printHistogramResult will print one line of results for a histogram kernel
+ */
+static void printHistogramResult(const char* functionName, uint64_t total, int t, uint32_t B, double skew,
+                                 double seconds) {
+    std::cout << functionName << "\t" << total << "\t" << t << "\t" << B << "\t" << skew << "\t"
+              << total/(seconds*1000) << "\t" << seconds << "\n";
+}
+
+/*
+ * timeHistograms will build a B bin histogram of input with t threads, each taking a
+ * contiguous slice, three ways:
+ *
+ * atomicBins - every thread fetch_adds into one shared array of bins
+ * privateBins - every thread counts into its own array, merged once all are joined
+ * paddedShardedBins - bins padded to a cache line each, with pairs of threads sharing
+ *                     a shard of bins, merged once all are joined
+ *
+ * Merging is included in the time.  The final counter value of each is the sum of the
+ * bins and will be the input size
+ *
+ * Input Arguments:
+ * input - reference to the bin indices to count
+ * B - number of bins
+ * skew - Zipf exponent input was drawn with, printed in the results
+ * t - number of threads
+ *
+ * Return Values:
+ * None
+ */
+static void timeHistograms(const std::vector<uint32_t>& input, uint32_t B, double skew, int t) {
+    std::size_t n = input.size();
+
+    std::vector<std::atomic<uint64_t>> atomicBins(B);
+    double seconds = runThreads(t, [&](int iterator) {
+        std::size_t end = sliceBegin(n, t, iterator + 1);
+        for(std::size_t index = sliceBegin(n, t, iterator); index < end; ++index) {
+            atomicBins[input[index]].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    uint64_t total = 0;
+    for(auto& bin : atomicBins) {
+        total += bin.load();
+    }
+    printHistogramResult("atomicBins", total, t, B, skew, seconds);
+
+    std::vector<std::vector<uint64_t>> privateBins(t, std::vector<uint64_t>(B));
+    std::vector<uint64_t> mergedBins(B);
+    seconds = runThreads(t, [&](int iterator) {
+        std::vector<uint64_t>& myBins = privateBins[iterator];
+        std::size_t end = sliceBegin(n, t, iterator + 1);
+        for(std::size_t index = sliceBegin(n, t, iterator); index < end; ++index) {
+            ++myBins[input[index]];
+        }
+    });
+    int64_t t1 = nowNanoseconds();
+    for(auto& myBins : privateBins) {
+        for(uint32_t bin = 0; bin < B; ++bin) {
+            mergedBins[bin] += myBins[bin];
+        }
+    }
+    seconds += (nowNanoseconds() - t1) / 1e9;
+    total = 0;
+    for(uint64_t bin : mergedBins) {
+        total += bin;
+    }
+    printHistogramResult("privateBins", total, t, B, skew, seconds);
+
+    int shards = (t + 1) / 2;
+    std::vector<PaddedBin> shardedBins(static_cast<std::size_t>(shards) * B);
+    std::fill(mergedBins.begin(), mergedBins.end(), 0);
+    seconds = runThreads(t, [&](int iterator) {
+        PaddedBin* myShard = &shardedBins[static_cast<std::size_t>(iterator / 2) * B];
+        std::size_t end = sliceBegin(n, t, iterator + 1);
+        for(std::size_t index = sliceBegin(n, t, iterator); index < end; ++index) {
+            myShard[input[index]].count.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    t1 = nowNanoseconds();
+    for(int shard = 0; shard < shards; ++shard) {
+        for(uint32_t bin = 0; bin < B; ++bin) {
+            mergedBins[bin] += shardedBins[static_cast<std::size_t>(shard) * B + bin].count.load();
+        }
+    }
+    seconds += (nowNanoseconds() - t1) / 1e9;
+    total = 0;
+    for(uint64_t bin : mergedBins) {
+        total += bin;
+    }
+    printHistogramResult("paddedShardedBins", total, t, B, skew, seconds);
+}
+
+/*
+ * runHistogramBenchmark will build histograms of t*i Zipf distributed bin indices with
+ * t threads, sweeping the number of bins and the skew of the input
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runHistogramBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    std::size_t n = static_cast<std::size_t>(t) * arguments.i;
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tBins\tSkew\tElements/Millisecond\tSeconds\n";
+
+    const uint32_t binCounts[] = {16, 256, 4096, 65536};
+    const double skews[] = {0.0, 1.0, 2.0};
+    for(uint32_t B : binCounts) {
+        for(double skew : skews) {
+            std::vector<uint32_t> input = generateZipfInput(n, B, skew);
+            timeHistograms(input, B, skew, t);
+        }
+    }
+}
@@ -0,0 +1,251 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <atomic>                       // std::atomic<uint8_t> and compare_exchange_weak()
+#include <algorithm>                    // std::fill()
+#include <optional>                     // std::optional<>
+#include <cmath>                        // std::log() and std::fabs()
+#include <cstring>                      // memchr()
+#include <string_view>                  // std::string_view
+#include <unordered_set>                // std::unordered_set<>
+#include <immintrin.h>                  // AVX2 and AVX-512 intrinsics
+#include "parcount.h"
+
+/*
+ * Sketches have 2^hllPrecision one byte registers, for a standard error of about
+ * 1.04/sqrt(2^hllPrecision), or 0.8%
+ */
+const int hllPrecision = 14;
+const std::size_t hllRegisters = std::size_t(1) << hllPrecision;
+
+/*
+ * hllRegister will return the register a hash updates, taken from its top bits
+ */
+static inline std::size_t hllRegister(uint64_t hash) {
+    return hash >> (64 - hllPrecision);
+}
+
+/*
+ * hllRank will return the position of the first set bit of the hash bits below the
+ * register index, counting from 1.  All zero bits give the largest rank
+ */
+static inline uint8_t hllRank(uint64_t hash) {
+    uint64_t remaining = hash << hllPrecision;
+    return remaining ? __builtin_clzll(remaining) + 1 : 64 - hllPrecision + 1;
+}
+
+/*
+ * hllEstimate will return the HyperLogLog estimate of the number of distinct hashes
+ * recorded in registers, falling back to linear counting of the empty registers while
+ * the estimate is small
+ *
+ * Input Arguments:
+ * registers - pointer to the hllRegisters registers
+ *
+ * Return Values:
+ * Estimated number of distinct elements
+ */
+static double hllEstimate(const uint8_t* registers) {
+    double m = hllRegisters;
+    double sum = 0;
+    std::size_t zeros = 0;
+    for(std::size_t index = 0; index < hllRegisters; ++index) {
+        sum += std::ldexp(1.0, -registers[index]);
+        zeros += registers[index] == 0;
+    }
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+}
+
+/*
+ * Each merge function sets every register of target to the larger of itself and the
+ * same register of source, which leaves target the sketch of the union of both streams
+ */
+typedef void (*MergeFunction)(uint8_t* target, const uint8_t* source, std::size_t n);
+
+static void mergeRegistersScalar(uint8_t* target, const uint8_t* source, std::size_t n) {
+    for(std::size_t index = 0; index < n; ++index) {
+        target[index] = target[index] > source[index] ? target[index] : source[index];
+    }
+}
+
+__attribute__((target("avx2")))
+static void mergeRegistersAvx2(uint8_t* target, const uint8_t* source, std::size_t n) {
+    std::size_t index = 0;
+    for(; index + 32 <= n; index += 32) {
+        __m256i maximum = _mm256_max_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(target + index)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + index)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + index), maximum);
+    }
+    mergeRegistersScalar(target + index, source + index, n - index);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void mergeRegistersAvx512(uint8_t* target, const uint8_t* source, std::size_t n) {
+    std::size_t index = 0;
+    for(; index + 64 <= n; index += 64) {
+        __m512i maximum = _mm512_max_epu8(_mm512_loadu_si512(target + index), _mm512_loadu_si512(source + index));
+        _mm512_storeu_si512(target + index, maximum);
+    }
+    mergeRegistersScalar(target + index, source + index, n - index);
+}
+
+/*
+ * DistinctInput is the stream whose distinct elements are counted: either generated
+ * integer keys, or the delimiter separated records of a mapped file split into record
+ * aligned slices
+ */
+struct DistinctInput {
+    std::vector<uint64_t> keys;
+    const uint8_t* data = nullptr;
+    std::vector<std::size_t> boundaries;
+    uint8_t delimiter = '\n';
+};
+
+/*
+ * visitSliceHashes will call visit with the hash of every element in thread iterator's
+ * slice of input.  Keys are hashed with mixHash and records, without their delimiter,
+ * with hashBytes
+ */
+template <typename Visit>
+static void visitSliceHashes(const DistinctInput& input, int t, int iterator, Visit visit) {
+    if (!input.data) {
+        std::size_t end = sliceBegin(input.keys.size(), t, iterator + 1);
+        for(std::size_t index = sliceBegin(input.keys.size(), t, iterator); index < end; ++index) {
+            visit(mixHash(input.keys[index]));
+        }
+        return;
+    }
+    const uint8_t* record = input.data + input.boundaries[iterator];
+    const uint8_t* end = input.data + input.boundaries[iterator + 1];
+    while (record < end) {
+        const void* found = memchr(record, input.delimiter, end - record);
+        const uint8_t* recordEnd = found ? static_cast<const uint8_t*>(found) : end;
+        visit(hashBytes(record, recordEnd - record));
+        record = recordEnd + 1;
+    }
+}
+
+/*
+ * printDistinctResult will print one line of results for a distinct counting kernel
+ */
+static void printDistinctResult(const char* functionName, double estimate, int t, const char* instructionSet,
+                                std::size_t elements, std::size_t exact, double mergeSeconds, double seconds) {
+    std::cout << functionName << "\t" << static_cast<uint64_t>(estimate + 0.5) << "\t" << t << "\t"
+              << instructionSet << "\t" << elements << "\t" << exact << "\t"
+              << (exact ? std::fabs(estimate - exact) / exact : 0.0) << "\t" << elements/(seconds*1000) << "\t"
+              << mergeSeconds << "\t" << seconds << "\n";
+}
+
+/*
+ * runHyperLogLogBenchmark will estimate the number of distinct elements in a stream
+ * with t threads, each taking a contiguous slice, two ways:
+ *
+ * sharedAtomicSketch - every thread raises the registers of one shared sketch with a
+ *                      compare and swap loop
+ * privateSketches - every thread fills its own sketch, merged by register max once all
+ *                   are joined, with every instruction set the processor supports
+ *
+ * The stream is t*i keys drawn from k distinct values, or the records of the file named
+ * by --file separated by the delimiter byte (newlines unless -d is given).  Merging is
+ * included in the time.  The exact distinct count is computed untimed with a hash set
+ * to report the relative error of each estimate
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runHyperLogLogBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    DistinctInput input;
+    input.delimiter = arguments.delimiter;
+    std::size_t elements = 0;
+    std::size_t exact = 0;
+
+    std::optional<MappedFile> file;
+    if (!arguments.file.empty()) {
+        file.emplace(arguments.file);
+        if (!file->error.empty()) {
+            std::cerr << arguments.file << ": " << file->error << "\n";
+            return;
+        }
+        input.data = file->data;
+        input.boundaries = recordAlignedSlices(file->data, file->size, t, arguments.delimiter);
+        std::unordered_set<std::string_view> distinct;
+        const char* record = reinterpret_cast<const char*>(file->data);
+        const char* end = record + file->size;
+        while (record < end) {
+            const void* found = memchr(record, arguments.delimiter, end - record);
+            const char* recordEnd = found ? static_cast<const char*>(found) : end;
+            distinct.insert(std::string_view(record, recordEnd - record));
+            ++elements;
+            record = recordEnd + 1;
+        }
+        exact = distinct.size();
+    }
+    else {
+        elements = static_cast<std::size_t>(t) * arguments.i;
+        input.keys.resize(elements);
+        uint64_t k = arguments.k > 0 ? arguments.k : 1;
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for(auto& key : input.keys) {
+            key = nextRandom(state) % k;
+        }
+        exact = std::unordered_set<uint64_t>(input.keys.begin(), input.keys.end()).size();
+    }
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tInstruction Set\tElements\tExact Distinct\t"
+              << "Relative Error\tElements/Millisecond\tMerge Seconds\tSeconds\n";
+
+    std::vector<std::atomic<uint8_t>> sharedSketch(hllRegisters);
+    double seconds = runThreads(t, [&](int iterator) {
+        visitSliceHashes(input, t, iterator, [&](uint64_t hash) {
+            std::atomic<uint8_t>& reg = sharedSketch[hllRegister(hash)];
+            uint8_t rank = hllRank(hash);
+            uint8_t current = reg.load(std::memory_order_relaxed);
+            while (rank > current && !reg.compare_exchange_weak(current, rank, std::memory_order_relaxed)) {
+            }
+        });
+    });
+    std::vector<uint8_t> merged(hllRegisters);
+    for(std::size_t index = 0; index < hllRegisters; ++index) {
+        merged[index] = sharedSketch[index].load();
+    }
+    printDistinctResult("sharedAtomicSketch", hllEstimate(merged.data()), t, "scalar", elements, exact, 0, seconds);
+
+    struct NamedMerge {
+        const char* name;
+        MergeFunction merge;
+    };
+    std::vector<NamedMerge> merges = {{"scalar", mergeRegistersScalar}};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        merges.push_back(NamedMerge{"avx2", mergeRegistersAvx2});
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        merges.push_back(NamedMerge{"avx512", mergeRegistersAvx512});
+    }
+    for(const NamedMerge& namedMerge : merges) {
+        std::vector<std::vector<uint8_t>> privateSketches(t, std::vector<uint8_t>(hllRegisters));
+        seconds = runThreads(t, [&](int iterator) {
+            uint8_t* mySketch = privateSketches[iterator].data();
+            visitSliceHashes(input, t, iterator, [&](uint64_t hash) {
+                uint8_t& reg = mySketch[hllRegister(hash)];
+                uint8_t rank = hllRank(hash);
+                reg = reg > rank ? reg : rank;
+            });
+        });
+        int64_t t1 = nowNanoseconds();
+        std::fill(merged.begin(), merged.end(), 0);
+        for(auto& mySketch : privateSketches) {
+            namedMerge.merge(merged.data(), mySketch.data(), hllRegisters);
+        }
+        double mergeSeconds = (nowNanoseconds() - t1) / 1e9;
+        printDistinctResult("privateSketches", hllEstimate(merged.data()), t, namedMerge.name, elements, exact,
+                            mergeSeconds, seconds + mergeSeconds);
+    }
+}
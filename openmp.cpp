@@ -0,0 +1,64 @@
+#include <iostream>                     // std::cout and std::cerr
+#include "parcount.h"
+
+/*
+ * runOpenMpBenchmark will run the counter kernels, then do the same counting work, t
+ * threads incrementing i times each, with OpenMP worksharing loops and print their
+ * results beneath:
+ *
+ * ompReduction - '#pragma omp parallel for reduction(+:sharedCounter)', a private
+ *                copy per thread combined at the end like incrementiTimesLocalCounter
+ * ompAtomic - '#pragma omp atomic' around every increment like incrementiTimesAtomic
+ * ompCritical - '#pragma omp critical' around every increment, a lock taken per
+ *               increment rather than per thread as in incrementiTimesMutexLock
+ *
+ * The OpenMP runtime keeps its threads between parallel regions, so only the first
+ * region pays for creating them.  The kernels are only compiled into parcount_omp;
+ * without OpenMP this reports how to build it
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runOpenMpBenchmark(Arguments& arguments) {
+#ifdef _OPENMP
+    int t = arguments.t;
+    long n = static_cast<long>(t) * arguments.i;
+    int sharedCounter = 0;
+
+    runCounterBenchmark(arguments);
+
+    int64_t t1 = nowNanoseconds();
+    #pragma omp parallel for num_threads(t) schedule(static) reduction(+:sharedCounter)
+    for(long incrementCounter = 0; incrementCounter < n; ++incrementCounter) {
+        ++sharedCounter;
+    }
+    double seconds = (nowNanoseconds() - t1) / 1e9;
+    std::cout << "ompReduction\t" << sharedCounter << "\t" << t << "\t" << sharedCounter/(seconds*1000.0) << "\t" << seconds << "\n";
+    sharedCounter = 0;
+
+    t1 = nowNanoseconds();
+    #pragma omp parallel for num_threads(t) schedule(static)
+    for(long incrementCounter = 0; incrementCounter < n; ++incrementCounter) {
+        #pragma omp atomic
+        ++sharedCounter;
+    }
+    seconds = (nowNanoseconds() - t1) / 1e9;
+    std::cout << "ompAtomic\t" << sharedCounter << "\t" << t << "\t" << sharedCounter/(seconds*1000.0) << "\t" << seconds << "\n";
+    sharedCounter = 0;
+
+    t1 = nowNanoseconds();
+    #pragma omp parallel for num_threads(t) schedule(static)
+    for(long incrementCounter = 0; incrementCounter < n; ++incrementCounter) {
+        #pragma omp critical
+        ++sharedCounter;
+    }
+    seconds = (nowNanoseconds() - t1) / 1e9;
+    std::cout << "ompCritical\t" << sharedCounter << "\t" << t << "\t" << sharedCounter/(seconds*1000.0) << "\t" << seconds << "\n";
+#else
+    (void)arguments;
+    std::cerr << "Mode openmp needs the OpenMP build: make parcount_omp\n";
+#endif
+}
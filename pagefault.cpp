@@ -0,0 +1,110 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <cstring>                      // strerror()
+#include <cerrno>                       // errno
+#include <unistd.h>                     // sysconf()
+#include <sys/mman.h>                   // mmap() and munmap()
+#include <sys/resource.h>               // getrusage()
+#include "parcount.h"
+
+/*
+ * minorFaults will return the number of minor page faults the process has taken
+ */
+static long minorFaults() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+/*
+ * touchPages will write one byte to every page of data[0, size)
+ */
+static void touchPages(char* data, std::size_t size, std::size_t pageSize) {
+    for(std::size_t offset = 0; offset < size; offset += pageSize) {
+        data[offset] = 1;
+    }
+}
+
+/*
+ * timeFirstTouch will map size bytes of fresh anonymous memory, fault it in one of three
+ * ways, then have t threads each increment every word of their own contiguous slice,
+ * and print one line of results:
+ *
+ * mainThreadPrefault - the calling thread touches every page
+ * mapPopulate - mmap() faults every page in itself with MAP_POPULATE
+ * perThreadFirstTouch - each of the t threads touches the pages of its own slice
+ *
+ * The kernel places a page on the NUMA node of the thread that first touches it, so
+ * only perThreadFirstTouch puts every slice next to the thread that later uses it.  The
+ * fault time includes mmap().  Faults are counted for the whole process, and fewer than
+ * one per page are taken when transparent huge pages back the mapping
+ *
+ * Input Arguments:
+ * functionName - name printed for the placement, and which one to use
+ * size - number of bytes to map
+ * t - number of threads
+ * pageSize - size of a page in bytes
+ *
+ * Return Values:
+ * None
+ */
+static void timeFirstTouch(const std::string& functionName, std::size_t size, int t, std::size_t pageSize) {
+    long faultsBefore = minorFaults();
+    int64_t t1 = nowNanoseconds();
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | (functionName == "mapPopulate" ? MAP_POPULATE : 0);
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << functionName << ": " << strerror(errno) << "\n";
+        return;
+    }
+    char* data = static_cast<char*>(mapping);
+    std::size_t pages = size / pageSize;
+    if (functionName == "mainThreadPrefault") {
+        touchPages(data, size, pageSize);
+    }
+    else if (functionName == "perThreadFirstTouch") {
+        runThreads(t, [&](int iterator) {
+            std::size_t begin = sliceBegin(pages, t, iterator) * pageSize;
+            touchPages(data + begin, sliceBegin(pages, t, iterator + 1) * pageSize - begin, pageSize);
+        });
+    }
+    double faultSeconds = (nowNanoseconds() - t1) / 1e9;
+    long faults = minorFaults() - faultsBefore;
+
+    uint64_t* words = static_cast<uint64_t*>(mapping);
+    std::size_t n = size / sizeof(uint64_t);
+    double accessSeconds = runThreads(t, [&](int iterator) {
+        std::size_t end = sliceBegin(pages, t, iterator + 1) * pageSize / sizeof(uint64_t);
+        for(std::size_t index = sliceBegin(pages, t, iterator) * pageSize / sizeof(uint64_t); index < end; ++index) {
+            ++words[index];
+        }
+    });
+    munmap(mapping, size);
+
+    std::cout << functionName << "\t" << faults << "\t" << t << "\t" << size << "\t" << faults/faultSeconds << "\t"
+              << faultSeconds << "\t" << 2*n*sizeof(uint64_t)/accessSeconds/1e9 << "\t"
+              << faultSeconds + accessSeconds << "\n";
+}
+
+/*
+ * runPageFaultBenchmark will fault in s MiB of fresh anonymous memory from the calling
+ * thread, with MAP_POPULATE and from t threads in parallel, then time t threads reading
+ * and writing it.  The final counter value is the number of minor faults taken, and the
+ * access bandwidth counts both the read and the write of every word
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runPageFaultBenchmark(Arguments& arguments) {
+    std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    std::size_t size = (static_cast<std::size_t>(arguments.s) << 20) / pageSize * pageSize;
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tBytes\tFaults/Second\tFault Seconds\t"
+              << "Access GB/Second\tSeconds\n";
+    for(const char* functionName : {"mainThreadPrefault", "mapPopulate", "perThreadFirstTouch"}) {
+        timeFirstTouch(functionName, size, arguments.t, pageSize);
+    }
+}
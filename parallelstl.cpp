@@ -0,0 +1,151 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <numeric>                      // std::reduce() and std::transform_reduce()
+#include <functional>                   // std::plus<>
+#if __has_include(<execution>)
+#include <execution>                    // std::execution::seq, par and par_unseq
+#endif
+#ifdef PARCOUNT_TBB
+#include <tbb/global_control.h>         // tbb::global_control
+#endif
+#include "parcount.h"
+
+/*
+ * The execution policies are only used when the standard library implements them.
+ * libstdc++ runs par and par_unseq on TBB, which the makefile links as PARCOUNT_TBB when
+ * it is installed, and runs them sequentially otherwise
+ */
+#if defined(__cpp_lib_parallel_algorithm) && __cpp_lib_parallel_algorithm >= 201603L
+#define PARCOUNT_EXECUTION_POLICIES
+#endif
+
+/*
+ * printParallelStlResult will print one line of results for a reduction.  Relative to
+ * Threads is the throughput of the reduction over that of the hand threaded one
+ */
+static void printParallelStlResult(const char* functionName, uint64_t total, int t, const char* policy,
+                                   std::size_t bytes, double threadsSeconds, double seconds) {
+    std::cout << functionName << "\t" << total << "\t" << t << "\t" << policy << "\t" << bytes << "\t"
+              << bytes/seconds/1e9 << "\t" << threadsSeconds/seconds << "\t" << seconds << "\n";
+}
+
+/*
+ * timeReduction will time reduce() and print its result
+ *
+ * Input Arguments:
+ * functionName - name printed for the reduction
+ * policy - name of the execution policy reduce() runs under
+ * t - number of threads printed for the reduction
+ * bytes - size of the reduced input
+ * threadsSeconds - time taken by the hand threaded reduction of the same input
+ * reduce - function performing the reduction and returning its result
+ *
+ * Return Values:
+ * None
+ */
+template <typename Reduce>
+static void timeReduction(const char* functionName, const char* policy, int t, std::size_t bytes,
+                          double threadsSeconds, Reduce reduce) {
+    int64_t t1 = nowNanoseconds();
+    uint64_t total = reduce();
+    printParallelStlResult(functionName, total, t, policy, bytes, threadsSeconds, (nowNanoseconds() - t1) / 1e9);
+}
+
+/*
+ * runParallelStlBenchmark will do two reductions over s MiB of pseudorandom input, the
+ * sum of 32 bit values with std::reduce and the count of the delimiter byte with
+ * std::transform_reduce, under the seq, par and par_unseq execution policies.  Each is
+ * compared with the same reduction done by t threads summing contiguous slices into
+ * their own counts.  With TBB the parallel policies are limited to t threads, and
+ * without a parallel backend they run on one
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runParallelStlBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    std::size_t bytes = static_cast<std::size_t>(arguments.s) << 20;
+    std::size_t n = bytes / sizeof(uint32_t);
+    std::vector<uint32_t> values(n);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for(auto& value : values) {
+        value = nextRandom(state) >> 40;
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(values.data());
+    uint8_t delimiter = arguments.delimiter;
+    auto isDelimiter = [delimiter](uint8_t byte) -> uint64_t { return byte == delimiter; };
+
+#ifdef PARCOUNT_TBB
+    tbb::global_control threadLimit(tbb::global_control::max_allowed_parallelism, t);
+    int parallelThreads = t;
+#else
+    int parallelThreads = 1;
+#endif
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tPolicy\tBytes\tGB/Second\tRelative to Threads\tSeconds\n";
+
+    std::vector<PaddedCount> counts(t);
+    double threadsSeconds = runThreads(t, [&](int iterator) {
+        const uint32_t* slice = values.data() + sliceBegin(n, t, iterator);
+        std::size_t size = sliceBegin(n, t, iterator + 1) - sliceBegin(n, t, iterator);
+        uint64_t sum = 0;
+        for(std::size_t index = 0; index < size; ++index) {
+            sum += slice[index];
+        }
+        counts[iterator].count = sum;
+    });
+    uint64_t total = 0;
+    for(auto& count : counts) {
+        total += count.count;
+    }
+    printParallelStlResult("reduceSum", total, t, "threads", bytes, threadsSeconds, threadsSeconds);
+#ifdef PARCOUNT_EXECUTION_POLICIES
+    timeReduction("reduceSum", "seq", 1, bytes, threadsSeconds, [&] {
+        return std::reduce(std::execution::seq, values.begin(), values.end(), uint64_t(0));
+    });
+    timeReduction("reduceSum", "par", parallelThreads, bytes, threadsSeconds, [&] {
+        return std::reduce(std::execution::par, values.begin(), values.end(), uint64_t(0));
+    });
+    timeReduction("reduceSum", "par_unseq", parallelThreads, bytes, threadsSeconds, [&] {
+        return std::reduce(std::execution::par_unseq, values.begin(), values.end(), uint64_t(0));
+    });
+#else
+    timeReduction("reduceSum", "none", 1, bytes, threadsSeconds, [&] {
+        return std::reduce(values.begin(), values.end(), uint64_t(0));
+    });
+#endif
+
+    threadsSeconds = runThreads(t, [&](int iterator) {
+        const uint8_t* slice = data + sliceBegin(bytes, t, iterator);
+        std::size_t size = sliceBegin(bytes, t, iterator + 1) - sliceBegin(bytes, t, iterator);
+        uint64_t count = 0;
+        for(std::size_t index = 0; index < size; ++index) {
+            count += isDelimiter(slice[index]);
+        }
+        counts[iterator].count = count;
+    });
+    total = 0;
+    for(auto& count : counts) {
+        total += count.count;
+    }
+    printParallelStlResult("transformReduceCount", total, t, "threads", bytes, threadsSeconds, threadsSeconds);
+#ifdef PARCOUNT_EXECUTION_POLICIES
+    timeReduction("transformReduceCount", "seq", 1, bytes, threadsSeconds, [&] {
+        return std::transform_reduce(std::execution::seq, data, data + bytes, uint64_t(0), std::plus<>(), isDelimiter);
+    });
+    timeReduction("transformReduceCount", "par", parallelThreads, bytes, threadsSeconds, [&] {
+        return std::transform_reduce(std::execution::par, data, data + bytes, uint64_t(0), std::plus<>(), isDelimiter);
+    });
+    timeReduction("transformReduceCount", "par_unseq", parallelThreads, bytes, threadsSeconds, [&] {
+        return std::transform_reduce(std::execution::par_unseq, data, data + bytes, uint64_t(0), std::plus<>(),
+                                     isDelimiter);
+    });
+#else
+    timeReduction("transformReduceCount", "none", 1, bytes, threadsSeconds, [&] {
+        return std::transform_reduce(data, data + bytes, uint64_t(0), std::plus<>(), isDelimiter);
+    });
+#endif
+}
@@ -5,10 +5,16 @@
 #include <vector>                       // std::vector<>
 #include <mutex>                        // std::mutex
 #include <atomic>                       // std::atomic<int> and fetch_add()
+#include <functional>                   // std::function<>
+#include <algorithm>                    // std::sort()
+#include <pthread.h>                    // pthread_setaffinity_np()
+#include <sched.h>                      // sched_getaffinity() and cpu_set_t
+#include "parcount.h"
 
 std::mutex sharedCounter_mtx;
 std::atomic<bool> start(false);         // to ensure threads run in parallel
-std::vector<int> localCounterVector;
+thread_local int currentThreadIndex = -1;
+std::vector<int*> localCounterVector;   // each on its own cache line from sizedPool<cacheLineSize>()
 
 
 /*
@@ -88,7 +94,7 @@ void incrementiTimesAtomic(std::atomic<int>& sharedCounterAtomic, int& i) {
 }
 
 /*
- * incrementiTimesLocalCounter will run the command '++localCounterVector[iterator]'
+ * incrementiTimesLocalCounter will run the command '++*localCounterVector[iterator]'
  * i times once start is set to true
  *
  * Input Arguments:
@@ -98,39 +104,155 @@ void incrementiTimesAtomic(std::atomic<int>& sharedCounterAtomic, int& i) {
 void incrementiTimesLocalCounter(int iterator, int& i) {
     while (!start.load());
     for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
-        ++localCounterVector[iterator];
+        ++*localCounterVector[iterator];
     }
 }
 
-int main(int argc, char *argv[]) {
+/*
+ * incrementiTimesReturnCount will run the command '++localCounter' i times on a
+ * variable local to the calling thread.  It is the unit of work handed to tasks
+ *
+ * Input Arguments:
+ * i - the number of times to increment localCounter
+ *
+ * Return Values:
+ * The final value of localCounter
+ */
+int incrementiTimesReturnCount(int i) {
+    int localCounter = 0;
+    for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
+        ++localCounter;
+    }
+    return localCounter;
+}
 
-    // Default values for t and i are 4 and 10000, respectively
-    int t = 4;
-    int i = 10000;
+/*
+ * runThreads will create t threads each running threadFunction(iterator), set start
+ * to true, and wait for all of them to finish.  start is reset before returning.  Each
+ * thread's currentThreadIndex is its iterator, which selects its ObjectPool caches
+ *
+ * Input Arguments:
+ * t - number of threads to create
+ * threadFunction - function each thread runs, given the index of its thread
+ *
+ * Return Values:
+ * Seconds elapsed between setting start and the last join
+ */
+double runThreads(int t, const std::function<void(int)>& threadFunction) {
+    std::vector<std::thread> threadVector;
+    for(int iterator = 0; iterator < t; ++iterator) {
+        threadVector.push_back(std::thread([&threadFunction, iterator]() {
+            currentThreadIndex = iterator;
+            while (!start.load());
+            threadFunction(iterator);
+        }));
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    start = true;
+    for(auto& thread : threadVector) {
+        thread.join();
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    start = false;
+    std::chrono::duration<double> tDelta = t2-t1;
+    return tDelta.count();
+}
+
+/*
+ * percentile will sort samples and return the value below which fraction of them fall
+ *
+ * Input Arguments:
+ * samples - reference to the samples, sorted in place
+ * fraction - percentile to return, between 0 and 1
+ *
+ * Return Values:
+ * The requested percentile, or 0 if samples is empty
+ */
+double percentile(std::vector<double>& samples, double fraction) {
+    if (samples.empty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    std::size_t index = static_cast<std::size_t>(fraction * (samples.size() - 1));
+    return samples[index];
+}
+
+/*
+ * allowedCores will list the processors the calling thread is allowed to run on
+ *
+ * Input Arguments:
+ * None
+ *
+ * Return Values:
+ * Indices of the allowed processors, in increasing order
+ */
+std::vector<int> allowedCores() {
+    std::vector<int> cores;
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for(int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &cpuSet)) {
+                cores.push_back(core);
+            }
+        }
+    }
+    return cores;
+}
+
+/*
+ * pinToCore will restrict the calling thread to a single processor
+ *
+ * Input Arguments:
+ * core - index of the processor to run on
+ *
+ * Return Values:
+ * true if the affinity was set, false otherwise
+ */
+bool pinToCore(int core) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+/*
+ * doublingThreadCounts will list the thread counts a scaling sweep runs at: 1, 2, 4, ...
+ * up to and always including t
+ *
+ * Input Arguments:
+ * t - largest number of threads
+ *
+ * Return Values:
+ * Thread counts in increasing order
+ */
+std::vector<int> doublingThreadCounts(int t) {
+    std::vector<int> threadCounts;
+    for(int threads = 1; threads < t; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(t);
+    return threadCounts;
+}
+
+/*
+ * runCounterBenchmark will run each of the incrementiTimes kernels with t threads
+ * incrementing i times each and print one line of results per kernel
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runCounterBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
     int sharedCounter = 0;
     std::atomic<int> sharedCounterAtomic;
     sharedCounterAtomic = 0;
     std::vector<std::thread> threadVector;
 
-    /*
-     * Parsing command line arguments...
-     * Argument directly following "-t" (if any) will be t
-     * Argument directly following "-i" (if any) will be i
-     * If multiple "-t" or multiple "-i" flags are found, the last one will be used
-     * If "-t" or "-i" is the last command line argument, it will be ignored
-     */
-    int lastIndexToCheck = argc-1;
-    for(int argcIterator = 1; argcIterator < lastIndexToCheck; ++argcIterator) {
-        if(strcmp(argv[argcIterator], "-t") == 0) {
-            argcIterator += 1;
-            t = atoi(argv[argcIterator]);
-        }
-        else if (strcmp(argv[argcIterator], "-i") == 0) {
-            argcIterator += 1;
-            i = atoi(argv[argcIterator]);
-        }
-    }
-    
     std::cout << "Function Name\tFinal Counter Value\tThreads\tIncrements/Millisecond\tSeconds\n";
     
     /*
@@ -151,7 +273,7 @@ int main(int argc, char *argv[]) {
     auto t2 = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> tDelta = t2-t1;
     auto seconds = tDelta.count();
-    std::cout << "incrementiTimesRaceCondition\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter*1000/seconds << "\t" << seconds << "\n";
+    std::cout << "incrementiTimesRaceCondition\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter/(seconds*1000) << "\t" << seconds << "\n";
     sharedCounter = 0;
     threadVector.clear();
     start = false;
@@ -174,7 +296,7 @@ int main(int argc, char *argv[]) {
     t2 = std::chrono::high_resolution_clock::now();
     tDelta = t2-t1;
     seconds = tDelta.count();
-    std::cout << "incrementiTimesMutexLock\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter*1000/seconds << "\t" << seconds << "\n";
+    std::cout << "incrementiTimesMutexLock\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter/(seconds*1000) << "\t" << seconds << "\n";
     sharedCounter = 0;
     threadVector.clear();
     start = false;
@@ -197,7 +319,7 @@ int main(int argc, char *argv[]) {
     t2 = std::chrono::high_resolution_clock::now();
     tDelta = t2-t1;
     seconds = tDelta.count();
-    std::cout << "incrementiTimesLockGuard\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter*1000/seconds << "\t" << seconds << "\n";
+    std::cout << "incrementiTimesLockGuard\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter/(seconds*1000) << "\t" << seconds << "\n";
     sharedCounter = 0;
     threadVector.clear();
     start = false;
@@ -220,21 +342,26 @@ int main(int argc, char *argv[]) {
     t2 = std::chrono::high_resolution_clock::now();
     tDelta = t2-t1;
     seconds = tDelta.count();
-    std::cout << "incrementiTimesAtomic\t" << sharedCounterAtomic<< "\t" << t << "\t" << sharedCounterAtomic*1000/seconds << "\t" << seconds << "\n";
+    std::cout << "incrementiTimesAtomic\t" << sharedCounterAtomic<< "\t" << t << "\t" << sharedCounterAtomic/(seconds*1000) << "\t" << seconds << "\n";
     sharedCounterAtomic = 0;
     threadVector.clear();
     start = false;
     
     /*
-     * t threads each increment a local variable t times and write the local variable
-     * into the global vector localCounterVector.  After all threads have completed,
-     * the sum of all elements in localCounterVector is stored in sharedCounter
+     * t threads each increment their own counter in localCounterVector i times.  After
+     * all threads have completed, the sum of the counters is stored in sharedCounter.
+     * Every counter is a cache line sized ObjectPool object, so no two threads share a
+     * line, and all are allocated before the first thread is created so the vector is
+     * not reallocated while threads read it
      *
-     * t, Increments/Millisecond, and seconds will be printed, localCounterVector,
-     * sharedCounter and start will be reset
+     * t, Increments/Millisecond, and seconds will be printed, the counters returned to
+     * the pool, and localCounterVector, sharedCounter and start will be reset
      */
+    ObjectPool& counterPool = sizedPool<cacheLineSize>();
+    for(int iterator = 0; iterator < t; ++iterator) {
+        localCounterVector.push_back(new (counterPool.allocate()) int(0));
+    }
     for(int iterator = 0; iterator < t; ++iterator) {
-        localCounterVector.push_back(0);
         threadVector.push_back(std::thread(incrementiTimesLocalCounter, iterator, std::ref(i)));
     }
     t1 = std::chrono::high_resolution_clock::now();
@@ -242,16 +369,179 @@ int main(int argc, char *argv[]) {
     for(auto& t : threadVector) {
         t.join();
     }
-    for(auto& localCounter : localCounterVector) {
-        sharedCounter += localCounter;
+    for(int* localCounter : localCounterVector) {
+        sharedCounter += *localCounter;
     }
     t2 = std::chrono::high_resolution_clock::now();
     tDelta = t2-t1;
     seconds = tDelta.count();
-    std::cout << "incrementiTimesLocalCounter\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter*1000/seconds << "\t" << seconds << "\n";
+    std::cout << "incrementiTimesLocalCounter\t" << sharedCounter<< "\t" << t << "\t" << sharedCounter/(seconds*1000) << "\t" << seconds << "\n";
     sharedCounter = 0;
     threadVector.clear();
+    for(int* localCounter : localCounterVector) {
+        counterPool.deallocate(localCounter);
+    }
     localCounterVector.clear();
     start = false;
     
-}
\ No newline at end of file
+}
+
+int main(int argc, char *argv[]) {
+
+    // Default values for t and i are 4 and 10000, respectively
+    Arguments arguments;
+    arguments.t = 4;
+    arguments.i = 10000;
+    arguments.mode = "";
+    arguments.k = 1024;
+    arguments.g = 1000;
+    arguments.s = 64;
+    arguments.file = "";
+    arguments.delimiter = '\n';
+    arguments.placement = "all";
+
+    /*
+     * Parsing command line arguments...
+     * Argument directly following "-t" (if any) will be t
+     * Argument directly following "-i" (if any) will be i
+     * Argument directly following "-m" (if any) will be the benchmark mode
+     * Argument directly following "-k" (if any) will be the number of distinct keys
+     * Argument directly following "-g" (if any) will be the increments per task
+     * Argument directly following "-s" (if any) will be the input size in MiB
+     * Argument directly following "--file" (if any) will be the input file
+     * Argument directly following "-d" (if any) will be the record delimiter, either a
+     * single character or a decimal byte value
+     * Argument directly following "-p" (if any) will be the counter placement
+     * If multiple copies of a flag are found, the last one will be used
+     * If a flag is the last command line argument, it will be ignored
+     */
+    int lastIndexToCheck = argc-1;
+    for(int argcIterator = 1; argcIterator < lastIndexToCheck; ++argcIterator) {
+        if(strcmp(argv[argcIterator], "-t") == 0) {
+            argcIterator += 1;
+            arguments.t = atoi(argv[argcIterator]);
+        }
+        else if (strcmp(argv[argcIterator], "-i") == 0) {
+            argcIterator += 1;
+            arguments.i = atoi(argv[argcIterator]);
+        }
+        else if (strcmp(argv[argcIterator], "-m") == 0) {
+            argcIterator += 1;
+            arguments.mode = argv[argcIterator];
+        }
+        else if (strcmp(argv[argcIterator], "-k") == 0) {
+            argcIterator += 1;
+            arguments.k = atoi(argv[argcIterator]);
+        }
+        else if (strcmp(argv[argcIterator], "-g") == 0) {
+            argcIterator += 1;
+            arguments.g = atoi(argv[argcIterator]);
+        }
+        else if (strcmp(argv[argcIterator], "-s") == 0) {
+            argcIterator += 1;
+            arguments.s = atoi(argv[argcIterator]);
+        }
+        else if (strcmp(argv[argcIterator], "--file") == 0) {
+            argcIterator += 1;
+            arguments.file = argv[argcIterator];
+        }
+        else if (strcmp(argv[argcIterator], "-d") == 0) {
+            argcIterator += 1;
+            const char* delimiter = argv[argcIterator];
+            arguments.delimiter = strlen(delimiter) == 1 ? delimiter[0] : atoi(delimiter);
+        }
+        else if (strcmp(argv[argcIterator], "-p") == 0) {
+            argcIterator += 1;
+            arguments.placement = argv[argcIterator];
+        }
+    }
+
+    // Without "-m", count the input file if one was given and run the counter kernels otherwise
+    if(arguments.mode.empty()) {
+        arguments.mode = arguments.file.empty() ? "counter" : "file";
+    }
+
+    if(arguments.mode == "counter") {
+        runCounterBenchmark(arguments);
+    }
+    else if(arguments.mode == "hashmap") {
+        runHashMapBenchmark(arguments);
+    }
+    else if(arguments.mode == "barrier") {
+        runBarrierBenchmark(arguments);
+    }
+    else if(arguments.mode == "threadcreate") {
+        runThreadCreateBenchmark(arguments);
+    }
+    else if(arguments.mode == "pingpong") {
+        runPingPongBenchmark(arguments);
+    }
+    else if(arguments.mode == "async") {
+        runAsyncBenchmark(arguments);
+    }
+    else if(arguments.mode == "threadpool") {
+        runThreadPoolBenchmark(arguments);
+    }
+    else if(arguments.mode == "coroutine") {
+        runCoroutineBenchmark(arguments);
+    }
+    else if(arguments.mode == "condvar") {
+        runCondVarBenchmark(arguments);
+    }
+    else if(arguments.mode == "buffer") {
+        runBufferCountBenchmark(arguments);
+    }
+    else if(arguments.mode == "histogram") {
+        runHistogramBenchmark(arguments);
+    }
+    else if(arguments.mode == "file") {
+        runFileCountBenchmark(arguments);
+    }
+    else if(arguments.mode == "stream") {
+        runStreamCountBenchmark(arguments);
+    }
+    else if(arguments.mode == "readbackend") {
+        runReadBackendBenchmark(arguments);
+    }
+    else if(arguments.mode == "scan") {
+        runScanBenchmark(arguments);
+    }
+    else if(arguments.mode == "popcount") {
+        runPopcountBenchmark(arguments);
+    }
+    else if(arguments.mode == "hll") {
+        runHyperLogLogBenchmark(arguments);
+    }
+    else if(arguments.mode == "countmin") {
+        runCountMinBenchmark(arguments);
+    }
+    else if(arguments.mode == "wordcount") {
+        runWordCountBenchmark(arguments);
+    }
+    else if(arguments.mode == "openmp") {
+        runOpenMpBenchmark(arguments);
+    }
+    else if(arguments.mode == "pstl") {
+        runParallelStlBenchmark(arguments);
+    }
+    else if(arguments.mode == "allocator") {
+        runAllocatorBenchmark(arguments);
+    }
+    else if(arguments.mode == "pool") {
+        runPoolBenchmark(arguments);
+    }
+    else if(arguments.mode == "pagefault") {
+        runPageFaultBenchmark(arguments);
+    }
+    else if(arguments.mode == "placement") {
+        runPlacementBenchmark(arguments);
+    }
+    else if(arguments.mode == "process") {
+        runProcessCountBenchmark(arguments);
+    }
+    else {
+        std::cerr << "Unknown mode: " << arguments.mode << "\n";
+        return 1;
+    }
+    return 0;
+}
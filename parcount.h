@@ -0,0 +1,372 @@
+#ifndef PARCOUNT_H
+#define PARCOUNT_H
+
+#include <atomic>                       // std::atomic<bool>
+#include <chrono>                       // std::chrono::steady_clock::now()
+#include <cstdint>                      // uint64_t
+#include <functional>                   // std::function<>
+#include <mutex>                        // std::mutex and std::lock_guard<>
+#include <new>                          // ::operator new() and ::operator delete()
+#include <string>                       // std::string
+#include <thread>                       // std::this_thread::yield()
+#include <vector>                       // std::vector<>
+
+/*
+ * Arguments holds the values parsed from the command line
+ *
+ * t - number of threads
+ * i - number of increments (or operations) per thread
+ * mode - name of the benchmark to run
+ * k - number of distinct keys used by the keyed benchmarks, or the largest allocation in
+ *     bytes of the allocator benchmark
+ * g - number of increments per task used by the task based benchmarks
+ * s - size in MiB of the generated input used by the data parallel benchmarks
+ * file - path of the input file used by the file counting benchmarks
+ * delimiter - byte that ends each record of the input file
+ * placement - memory the counter placement benchmark puts its counters in, or all
+ */
+struct Arguments {
+    int t;
+    int i;
+    std::string mode;
+    int k;
+    int g;
+    int s;
+    std::string file;
+    uint8_t delimiter;
+    std::string placement;
+};
+
+extern std::atomic<bool> start;         // to ensure threads run in parallel
+extern std::mutex sharedCounter_mtx;    // guards sharedCounter in the mutex kernels
+extern thread_local int currentThreadIndex; // index runThreads gave this thread, or -1
+
+const std::size_t cacheLineSize = 64;   // padding to keep per-thread state off shared lines
+
+/*
+ * PaddedCount is a per-thread result on its own cache line
+ */
+struct alignas(cacheLineSize) PaddedCount {
+    uint64_t count = 0;
+};
+
+/*
+ * BytePredicate selects the bytes counted by the byte counting kernels: bytes equal to
+ * low, bytes in [low, high], or bytes sharing at least one set bit with low
+ */
+enum BytePredicateKind {
+    byteEquals,
+    byteInRange,
+    byteMasked
+};
+
+struct BytePredicate {
+    BytePredicateKind kind;
+    uint8_t low;
+    uint8_t high;
+};
+
+/*
+ * ByteCounter names one instruction set's byte counting function
+ */
+struct ByteCounter {
+    const char* name;
+    uint64_t (*count)(const uint8_t* data, std::size_t size, const BytePredicate& predicate);
+};
+
+/*
+ * MappedFile is a read-only private mapping of a whole file, unmapped on destruction
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+    std::string error;
+};
+
+/*
+ * ObjectPool hands out fixed size objects from chunks it never returns to the system
+ * until it is destroyed.  Every thread started by runThreads allocates from and frees
+ * into a cache of its own, indexed by currentThreadIndex, without synchronization.  A
+ * cache that runs dry takes a batch of poolBatch objects from a lock-free global stack
+ * of batches, or carves a new chunk, and a cache holding two batches pushes one back,
+ * so objects freed by another thread than the one that allocated them flow back.
+ * Threads without an index share one cache behind a mutex
+ */
+class ObjectPool {
+public:
+    static const int maxCaches = 256;
+    static const int poolBatch = 64;
+
+    explicit ObjectPool(std::size_t objectSize);
+    ~ObjectPool();
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    void* allocate() {
+        int index = currentThreadIndex;
+        if (index < 0 || index >= maxCaches) {
+            std::lock_guard<std::mutex> lock(sharedCacheMutex);
+            return allocateFrom(caches[maxCaches]);
+        }
+        return allocateFrom(caches[index]);
+    }
+
+    void deallocate(void* object) {
+        int index = currentThreadIndex;
+        if (index < 0 || index >= maxCaches) {
+            std::lock_guard<std::mutex> lock(sharedCacheMutex);
+            deallocateTo(caches[maxCaches], object);
+            return;
+        }
+        deallocateTo(caches[index], object);
+    }
+
+private:
+    struct FreeObject {
+        FreeObject* next;               // next object in the same cache or batch
+        FreeObject* nextBatch;          // next batch on the global stack, set on a batch's first object
+    };
+
+    struct alignas(cacheLineSize) Cache {
+        FreeObject* head = nullptr;
+        int count = 0;
+    };
+
+    void* allocateFrom(Cache& cache) {
+        if (!cache.head) {
+            refill(cache);
+        }
+        FreeObject* object = cache.head;
+        cache.head = object->next;
+        --cache.count;
+        return object;
+    }
+
+    void deallocateTo(Cache& cache, void* object) {
+        FreeObject* freed = static_cast<FreeObject*>(object);
+        freed->next = cache.head;
+        cache.head = freed;
+        if (++cache.count >= 2 * poolBatch) {
+            flush(cache);
+        }
+    }
+
+    void refill(Cache& cache);
+    void flush(Cache& cache);
+    void pushBatch(FreeObject* batch);
+    FreeObject* popBatch();
+
+    std::size_t objectSize;
+    std::vector<Cache> caches;
+    std::mutex sharedCacheMutex;
+    alignas(cacheLineSize) std::atomic<uint64_t> freeBatches{0};
+    std::mutex chunkMutex;
+    std::vector<void*> chunks;
+};
+
+/*
+ * sizedPool will return the process wide ObjectPool for objects of size bytes
+ */
+template <std::size_t size>
+inline ObjectPool& sizedPool() {
+    static ObjectPool pool(size);
+    return pool;
+}
+
+/*
+ * PoolAllocator is a standard allocator that takes single objects, such as the nodes of
+ * std::unordered_map<>, from the ObjectPool for their size.  Arrays come from operator
+ * new as usual
+ */
+template <typename T>
+struct PoolAllocator {
+    typedef T value_type;
+    static_assert(alignof(T) <= 16, "ObjectPool objects are 16 byte aligned");
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        if (n == 1) {
+            return static_cast<T*>(sizedPool<sizeof(T)>().allocate());
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* object, std::size_t n) {
+        if (n == 1) {
+            sizedPool<sizeof(T)>().deallocate(object);
+        }
+        else {
+            ::operator delete(object);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+/*
+ * spinUntil will busy wait until done() returns true, yielding the processor every
+ * so often so that runs with more threads than cores still make progress
+ *
+ * Input Arguments:
+ * done - predicate to poll
+ *
+ * Return Values:
+ * None
+ */
+template <typename Predicate>
+inline void spinUntil(Predicate done) {
+    for(int spinCounter = 1; !done(); ++spinCounter) {
+        if (spinCounter % 1024 == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/*
+ * nowNanoseconds will return the steady clock time in nanoseconds
+ */
+inline int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * sliceBegin will return the first index of thread iterator's slice when n items are
+ * split into t contiguous slices whose sizes differ by at most one.  The slice ends
+ * where the slice of thread iterator + 1 begins
+ */
+inline std::size_t sliceBegin(std::size_t n, int t, int iterator) {
+    std::size_t remainder = n % t;
+    return n / t * iterator + (static_cast<std::size_t>(iterator) < remainder ? iterator : remainder);
+}
+
+/*
+ * nextRandom will advance the xorshift64* generator state and return the next value.
+ * state must be nonzero
+ *
+ * Input Arguments:
+ * state - reference to the generator state
+ *
+ * Return Values:
+ * Next pseudorandom 64 bit value
+ */
+inline uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * mixHash will scramble the bits of key with the splitmix64 finalizer
+ *
+ * Input Arguments:
+ * key - value to hash
+ *
+ * Return Values:
+ * 64 bit hash of key
+ */
+inline uint64_t mixHash(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return key;
+}
+
+/*
+ * hashBytes will hash data[0, size) with 64 bit FNV-1a followed by mixHash, which
+ * spreads FNV's weak low bits over the whole word
+ *
+ * Input Arguments:
+ * data - pointer to the first byte
+ * size - number of bytes
+ *
+ * Return Values:
+ * 64 bit hash of the bytes
+ */
+inline uint64_t hashBytes(const uint8_t* data, std::size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for(std::size_t index = 0; index < size; ++index) {
+        hash = (hash ^ data[index]) * 0x100000001B3ULL;
+    }
+    return mixHash(hash);
+}
+
+/*
+ * scalingEfficiency will return the throughput of a run over that of one thread times
+ * the number of threads, for a sweep in which every thread does the same work at every
+ * thread count.  The throughputs' ratio over the thread count reduces to the ratio of
+ * the times
+ *
+ * Input Arguments:
+ * singleThreadSeconds - seconds taken with one thread
+ * seconds - seconds taken with the number of threads being compared
+ *
+ * Return Values:
+ * 1 for perfect scaling, less when threads slow each other down
+ */
+inline double scalingEfficiency(double singleThreadSeconds, double seconds) {
+    return singleThreadSeconds / seconds;
+}
+
+void incrementiTimesRaceCondition(int& sharedCounter, int& i);
+void incrementiTimesMutexLock(int& sharedCounter, int& i);
+void incrementiTimesLockGuard(int& sharedCounter, int& i);
+void incrementiTimesAtomic(std::atomic<int>& sharedCounterAtomic, int& i);
+int incrementiTimesReturnCount(int i);
+double runThreads(int t, const std::function<void(int)>& threadFunction);
+double percentile(std::vector<double>& samples, double fraction);
+std::vector<int> allowedCores();
+bool pinToCore(int core);
+std::vector<int> doublingThreadCounts(int t);
+std::vector<ByteCounter> supportedByteCounters();
+ByteCounter bestByteCounter();
+uint64_t countBytesInParallel(const ByteCounter& counter, const uint8_t* data, std::size_t size,
+                              const BytePredicate& predicate, int t, double& seconds);
+std::vector<uint32_t> generateZipfInput(std::size_t n, uint32_t B, double skew);
+std::vector<std::size_t> recordAlignedSlices(const uint8_t* data, std::size_t size, int t, uint8_t delimiter);
+uint64_t countMappedFile(const std::string& path, int t, uint8_t delimiter, const ByteCounter& counter,
+                         std::size_t& bytes, std::string& error);
+
+void runCounterBenchmark(Arguments& arguments);
+void runHashMapBenchmark(Arguments& arguments);
+void runBarrierBenchmark(Arguments& arguments);
+void runThreadCreateBenchmark(Arguments& arguments);
+void runPingPongBenchmark(Arguments& arguments);
+void runAsyncBenchmark(Arguments& arguments);
+void runThreadPoolBenchmark(Arguments& arguments);
+void runCoroutineBenchmark(Arguments& arguments);
+void runCondVarBenchmark(Arguments& arguments);
+void runBufferCountBenchmark(Arguments& arguments);
+void runHistogramBenchmark(Arguments& arguments);
+void runFileCountBenchmark(Arguments& arguments);
+void runStreamCountBenchmark(Arguments& arguments);
+void runReadBackendBenchmark(Arguments& arguments);
+void runScanBenchmark(Arguments& arguments);
+void runPopcountBenchmark(Arguments& arguments);
+void runHyperLogLogBenchmark(Arguments& arguments);
+void runCountMinBenchmark(Arguments& arguments);
+void runWordCountBenchmark(Arguments& arguments);
+void runOpenMpBenchmark(Arguments& arguments);
+void runParallelStlBenchmark(Arguments& arguments);
+void runAllocatorBenchmark(Arguments& arguments);
+void runPoolBenchmark(Arguments& arguments);
+void runPageFaultBenchmark(Arguments& arguments);
+void runPlacementBenchmark(Arguments& arguments);
+void runProcessCountBenchmark(Arguments& arguments);
+
+#endif
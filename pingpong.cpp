@@ -0,0 +1,225 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <mutex>                        // std::mutex and std::unique_lock<>
+#include <condition_variable>           // std::condition_variable
+#include <atomic>                       // std::atomic<int>, wait() and notify_one()
+#include <cstring>                      // strerror()
+#include <cerrno>                       // errno and EINTR
+#include <unistd.h>                     // pipe(), read(), write() and syscall()
+#include <sys/eventfd.h>                // eventfd()
+#include <sys/syscall.h>                // SYS_futex
+#include <linux/futex.h>                // FUTEX_WAIT_PRIVATE and FUTEX_WAKE_PRIVATE
+#include "parcount.h"
+
+/*
+ * Each channel below carries a one-way wakeup from one thread to another.  signal()
+ * makes one pending wakeup available and wait() blocks until it can consume one.  The
+ * channels built on file descriptors set error if the descriptors could not be had
+ */
+
+/*
+ * FutexChannel blocks on the raw futex system call.  wait() only enters the kernel
+ * when the word is still 0, and the kernel rechecks that atomically
+ */
+class FutexChannel {
+public:
+    void signal() {
+        word.store(1, std::memory_order_release);
+        syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+    void wait() {
+        while (word.exchange(0, std::memory_order_acquire) == 0) {
+            syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0);
+        }
+    }
+
+private:
+    std::atomic<int> word{0};
+};
+
+class CondVarChannel {
+public:
+    void signal() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            ready = true;
+        }
+        cv.notify_one();
+    }
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return ready; });
+        ready = false;
+    }
+
+private:
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool ready = false;
+};
+
+class AtomicWaitChannel {
+public:
+    void signal() {
+        word.store(1, std::memory_order_release);
+        word.notify_one();
+    }
+    void wait() {
+        while (word.exchange(0, std::memory_order_acquire) == 0) {
+            word.wait(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<int> word{0};
+};
+
+class PipeChannel {
+public:
+    PipeChannel() {
+        if (pipe(fds) != 0) {
+            error = strerror(errno);
+            fds[0] = fds[1] = -1;
+        }
+    }
+    ~PipeChannel() {
+        if (fds[0] >= 0) {
+            close(fds[0]);
+            close(fds[1]);
+        }
+    }
+    void signal() {
+        char byte = 1;
+        while (write(fds[1], &byte, 1) < 0 && errno == EINTR);
+    }
+    void wait() {
+        char byte;
+        while (read(fds[0], &byte, 1) < 0 && errno == EINTR);
+    }
+
+    std::string error;
+
+private:
+    int fds[2];
+};
+
+class EventfdChannel {
+public:
+    EventfdChannel() : fd(eventfd(0, 0)) {
+        if (fd < 0) {
+            error = strerror(errno);
+        }
+    }
+    ~EventfdChannel() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    void signal() {
+        uint64_t one = 1;
+        while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR);
+    }
+    void wait() {
+        uint64_t value;
+        while (read(fd, &value, sizeof(value)) < 0 && errno == EINTR);
+    }
+
+    std::string error;
+
+private:
+    int fd;
+};
+
+/*
+ * timePingPong will bounce a wakeup between two threads i times over a pair of
+ * channels, pinning the threads to pingCore and pongCore, and print the round trip
+ * latency distribution.  A core of -1 leaves that thread unpinned, and nothing is timed
+ * if either channel reports an error
+ *
+ * Input Arguments:
+ * functionName - name printed in the results
+ * placement - description of the pinning printed in the results
+ * pingCore - processor for the thread that starts each round trip
+ * pongCore - processor for the thread that answers
+ * i - number of round trips
+ *
+ * Return Values:
+ * None
+ */
+template <typename Channel>
+void timePingPong(const char* functionName, const char* placement, int pingCore, int pongCore, int i) {
+    Channel ping;
+    Channel pong;
+    if constexpr (requires { ping.error; }) {
+        if (!ping.error.empty() || !pong.error.empty()) {
+            std::cerr << functionName << ": " << (ping.error.empty() ? pong.error : ping.error) << "\n";
+            return;
+        }
+    }
+    std::vector<double> roundTrips(i);
+
+    double seconds = runThreads(2, [&](int iterator) {
+        if (iterator == 0) {
+            if (pingCore >= 0) {
+                pinToCore(pingCore);
+            }
+            for(int roundTrip = 0; roundTrip < i; ++roundTrip) {
+                int64_t t1 = nowNanoseconds();
+                ping.signal();
+                pong.wait();
+                roundTrips[roundTrip] = (nowNanoseconds() - t1) / 1000.0;
+            }
+        }
+        else {
+            if (pongCore >= 0) {
+                pinToCore(pongCore);
+            }
+            for(int roundTrip = 0; roundTrip < i; ++roundTrip) {
+                ping.wait();
+                pong.signal();
+            }
+        }
+    });
+
+    std::cout << functionName << "\t" << placement << "\t" << i << "\t"
+              << percentile(roundTrips, 0.5) << "\t" << percentile(roundTrips, 0.99) << "\t"
+              << percentile(roundTrips, 1.0) << "\t" << i/seconds << "\t" << seconds << "\n";
+}
+
+/*
+ * timePingPongPlacements will run timePingPong with both threads on the first allowed
+ * core, then with the threads on two different cores if more than one is allowed
+ */
+template <typename Channel>
+void timePingPongPlacements(const char* functionName, const std::vector<int>& cores, int i) {
+    int firstCore = cores.empty() ? -1 : cores[0];
+    timePingPong<Channel>(functionName, "sameCore", firstCore, firstCore, i);
+    if (cores.size() > 1) {
+        timePingPong<Channel>(functionName, "differentCores", cores[0], cores[1], i);
+    }
+}
+
+/*
+ * runPingPongBenchmark will measure the blocking handoff round trip between two threads
+ * over futex, std::condition_variable, std::atomic<>::wait(), a pipe, and an eventfd.
+ * The different core placement is skipped when only one core is available
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runPingPongBenchmark(Arguments& arguments) {
+    int i = arguments.i;
+    std::vector<int> cores = allowedCores();
+
+    std::cout << "Function Name\tPlacement\tRound Trips\tMedian Round Trip (us)\tP99 Round Trip (us)\t"
+              << "Max Round Trip (us)\tRound Trips/Second\tSeconds\n";
+
+    timePingPongPlacements<FutexChannel>("futex", cores, i);
+    timePingPongPlacements<CondVarChannel>("conditionVariable", cores, i);
+    timePingPongPlacements<AtomicWaitChannel>("atomicWait", cores, i);
+    timePingPongPlacements<PipeChannel>("pipe", cores, i);
+    timePingPongPlacements<EventfdChannel>("eventfd", cores, i);
+}
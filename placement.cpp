@@ -0,0 +1,162 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <new>                          // placement new
+#include <cstdlib>                      // mkstemp()
+#include <cstring>                      // strerror()
+#include <cerrno>                       // errno
+#include <unistd.h>                     // sysconf(), ftruncate(), unlink() and close()
+#include <sys/mman.h>                   // mmap() and munmap()
+#include "parcount.h"
+
+/*
+ * CounterCells holds the counters the shared counter kernels increment
+ */
+struct CounterCells {
+    int sharedCounter = 0;
+    std::atomic<int> sharedCounterAtomic{0};
+};
+
+static CounterCells staticCells;
+
+/*
+ * PlacedCounters constructs CounterCells in the memory named by placement and releases
+ * that memory on destruction:
+ *
+ * static - a global, as sharedCounter_mtx is
+ * stack - the caller's stackCells on the main thread's stack, as sharedCounter is
+ * heap - operator new
+ * mmap - a private anonymous mapping
+ * shared - a shared mapping of an unlinked temporary file
+ *
+ * cells is null and error describes the failure if the memory could not be had
+ */
+class PlacedCounters {
+public:
+    PlacedCounters(const std::string& placement, CounterCells& stackCells) : placement(placement) {
+        pageSize = sysconf(_SC_PAGESIZE);
+        if (placement == "static") {
+            cells = new (&staticCells) CounterCells;
+        }
+        else if (placement == "stack") {
+            cells = new (&stackCells) CounterCells;
+        }
+        else if (placement == "heap") {
+            cells = new CounterCells;
+        }
+        else if (placement == "mmap" || placement == "shared") {
+            int fd = -1;
+            if (placement == "shared") {
+                char path[] = "/tmp/parcountXXXXXX";
+                fd = mkstemp(path);
+                if (fd < 0 || unlink(path) != 0 || ftruncate(fd, pageSize) != 0) {
+                    error = strerror(errno);
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                    return;
+                }
+            }
+            int flags = fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED;
+            void* memory = mmap(nullptr, pageSize, PROT_READ | PROT_WRITE, flags, fd, 0);
+            if (fd >= 0) {
+                close(fd);
+            }
+            if (memory == MAP_FAILED) {
+                error = strerror(errno);
+                return;
+            }
+            mapping = memory;
+            cells = new (memory) CounterCells;
+        }
+        else {
+            error = "unknown placement";
+        }
+    }
+
+    ~PlacedCounters() {
+        if (placement == "heap") {
+            delete cells;
+        }
+        else if (mapping) {
+            munmap(mapping, pageSize);
+        }
+    }
+
+    PlacedCounters(const PlacedCounters&) = delete;
+    PlacedCounters& operator=(const PlacedCounters&) = delete;
+
+    CounterCells* cells = nullptr;
+    std::string error;
+
+private:
+    std::string placement;
+    std::size_t pageSize;
+    void* mapping = nullptr;
+};
+
+/*
+ * timePlacedKernel will have t threads run kernel on counter i times each and print one
+ * line of results, then reset counter
+ *
+ * Input Arguments:
+ * functionName - name of kernel printed in the results
+ * kernel - counter kernel to run
+ * counter - reference to the placed counter kernel increments
+ * t - number of threads
+ * i - number of increments per thread
+ * placement - name of the memory counter is placed in
+ *
+ * Return Values:
+ * None
+ */
+template <typename Counter>
+static void timePlacedKernel(const char* functionName, void (*kernel)(Counter&, int&), Counter& counter, int t,
+                             int i, const std::string& placement) {
+    double seconds = runThreads(t, [&](int) {
+        int increments = i;
+        kernel(counter, increments);
+    });
+    int finalValue = counter;
+    std::cout << functionName << "\t" << finalValue << "\t" << t << "\t" << placement << "\t"
+              << reinterpret_cast<uintptr_t>(&counter) % cacheLineSize << "\t" << finalValue/(seconds*1000.0) << "\t"
+              << seconds << "\n";
+    counter = 0;
+}
+
+/*
+ * runPlacementBenchmark will run the shared counter kernels with t threads incrementing
+ * i times each, with the counters placed in each kind of memory PlacedCounters offers,
+ * or only the one named by -p.  Line Offset is the counter's byte offset within its
+ * cache line.  incrementiTimesLocalCounter is left out since its counters are not shared
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runPlacementBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+    CounterCells stackCells;
+
+    std::vector<std::string> placements = {"static", "stack", "heap", "mmap", "shared"};
+    if (arguments.placement != "all") {
+        placements = {arguments.placement};
+    }
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tPlacement\tLine Offset\tIncrements/Millisecond\tSeconds\n";
+    for(const std::string& placement : placements) {
+        PlacedCounters placed(placement, stackCells);
+        if (!placed.cells) {
+            std::cerr << placement << ": " << placed.error << "\n";
+            continue;
+        }
+        CounterCells& cells = *placed.cells;
+        timePlacedKernel("incrementiTimesRaceCondition", incrementiTimesRaceCondition, cells.sharedCounter, t, i,
+                         placement);
+        timePlacedKernel("incrementiTimesMutexLock", incrementiTimesMutexLock, cells.sharedCounter, t, i, placement);
+        timePlacedKernel("incrementiTimesLockGuard", incrementiTimesLockGuard, cells.sharedCounter, t, i, placement);
+        timePlacedKernel("incrementiTimesAtomic", incrementiTimesAtomic, cells.sharedCounterAtomic, t, i, placement);
+    }
+}
@@ -0,0 +1,211 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <barrier>                      // std::barrier<>
+#include <memory>                       // std::allocator<>, std::unique_ptr<> and std::make_unique()
+#include <algorithm>                    // std::max()
+#include "parcount.h"
+
+/*
+ * The global stack of batches is a tagged pointer: the low 48 bits address the first
+ * object of the top batch, which is all x86-64 and AArch64 user space uses, and the top
+ * 16 bits count pushes and pops so a batch popped and pushed back between another
+ * thread's load and compare and swap (the ABA problem) fails that compare and swap.
+ * Chunks are only freed with the pool, so reading nextBatch of a batch another thread
+ * has just popped is safe; the stale value is discarded when the tag no longer matches
+ */
+const uint64_t pointerMask = (uint64_t(1) << 48) - 1;
+const uint64_t tagIncrement = uint64_t(1) << 48;
+
+ObjectPool::ObjectPool(std::size_t size)
+    : objectSize((std::max(size, sizeof(FreeObject)) + 15) / 16 * 16), caches(maxCaches + 1) {
+}
+
+ObjectPool::~ObjectPool() {
+    for(void* chunk : chunks) {
+        ::operator delete(chunk, std::align_val_t(cacheLineSize));
+    }
+}
+
+/*
+ * refill will give an empty cache a batch from the global stack, or one carved from a
+ * new chunk if the stack is empty
+ */
+void ObjectPool::refill(Cache& cache) {
+    FreeObject* batch = popBatch();
+    if (!batch) {
+        char* chunk = static_cast<char*>(::operator new(objectSize * poolBatch, std::align_val_t(cacheLineSize)));
+        {
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            chunks.push_back(chunk);
+        }
+        for(int object = 0; object < poolBatch; ++object) {
+            reinterpret_cast<FreeObject*>(chunk + object * objectSize)->next =
+                object + 1 < poolBatch ? reinterpret_cast<FreeObject*>(chunk + (object + 1) * objectSize) : nullptr;
+        }
+        batch = reinterpret_cast<FreeObject*>(chunk);
+    }
+    cache.head = batch;
+    cache.count = poolBatch;
+}
+
+/*
+ * flush will move the poolBatch objects beneath the head of a full cache to the global
+ * stack as one batch
+ */
+void ObjectPool::flush(Cache& cache) {
+    FreeObject* last = cache.head;
+    for(int object = 1; object < poolBatch; ++object) {
+        last = last->next;
+    }
+    FreeObject* batch = cache.head;
+    cache.head = last->next;
+    last->next = nullptr;
+    cache.count -= poolBatch;
+    pushBatch(batch);
+}
+
+void ObjectPool::pushBatch(FreeObject* batch) {
+    uint64_t head = freeBatches.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do {
+        batch->nextBatch = reinterpret_cast<FreeObject*>(head & pointerMask);
+        newHead = reinterpret_cast<uint64_t>(batch) | ((head & ~pointerMask) + tagIncrement);
+    } while (!freeBatches.compare_exchange_weak(head, newHead, std::memory_order_release,
+                                                std::memory_order_relaxed));
+}
+
+ObjectPool::FreeObject* ObjectPool::popBatch() {
+    uint64_t head = freeBatches.load(std::memory_order_acquire);
+    while (head & pointerMask) {
+        FreeObject* batch = reinterpret_cast<FreeObject*>(head & pointerMask);
+        uint64_t newHead = reinterpret_cast<uint64_t>(batch->nextBatch) | ((head & ~pointerMask) + tagIncrement);
+        if (freeBatches.compare_exchange_weak(head, newHead, std::memory_order_acquire,
+                                              std::memory_order_acquire)) {
+            return batch;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ * Message stands in for a fixed size message object
+ */
+struct Message {
+    uint64_t words[8];
+};
+
+/*
+ * escape keeps the compiler from eliding an allocation whose object is never read
+ */
+static inline void escape(void* object) {
+    asm volatile("" : : "g"(object) : "memory");
+}
+
+struct StandardMessageAllocator {
+    Message* allocate() { return allocator.allocate(1); }
+    void deallocate(Message* message) { allocator.deallocate(message, 1); }
+    std::allocator<Message> allocator;
+};
+
+struct PooledMessageAllocator {
+    Message* allocate() { return static_cast<Message*>(pool.allocate()); }
+    void deallocate(Message* message) { pool.deallocate(message); }
+    ObjectPool& pool;
+};
+
+/*
+ * timeMessages will sweep the thread count up to t, with every thread making i Message
+ * allocations through allocator in three sequences, and print one line of results per
+ * sequence and thread count:
+ *
+ * messagePairs - allocate then free straight away
+ * messageBatches - allocate a batch, then free it oldest first
+ * messageCrossThreadFree - allocate a batch, then free the batch the next thread
+ *                          allocated, with a barrier between the two halves of a round
+ *
+ * Input Arguments:
+ * allocatorName - name of allocator printed in the results
+ * allocator - reference to the allocator under test
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+template <typename Allocator>
+static void timeMessages(const char* allocatorName, Allocator& allocator, Arguments& arguments) {
+    const int batch = 256;
+    int i = arguments.i;
+    std::vector<std::vector<Message*>> outboxes;
+    std::unique_ptr<std::barrier<>> roundBarrier;
+    const char* functionNames[] = {"messagePairs", "messageBatches", "messageCrossThreadFree"};
+
+    for(int sequence = 0; sequence < 3; ++sequence) {
+        double singleThreadSeconds = 0;
+        for(int t : doublingThreadCounts(arguments.t)) {
+            outboxes.assign(t, std::vector<Message*>(batch));
+            roundBarrier = std::make_unique<std::barrier<>>(t);
+            double seconds = runThreads(t, [&](int iterator) {
+                if (sequence == 0) {
+                    for(int allocation = 0; allocation < i; ++allocation) {
+                        Message* message = allocator.allocate();
+                        message->words[0] = allocation;
+                        escape(message);
+                        allocator.deallocate(message);
+                    }
+                    return;
+                }
+                std::vector<Message*>& myOutbox = outboxes[iterator];
+                std::vector<Message*>& inbox = outboxes[sequence == 1 ? iterator : (iterator + 1) % t];
+                for(int allocation = 0; allocation < i; allocation += batch) {
+                    int batchSize = i - allocation < batch ? i - allocation : batch;
+                    for(int message = 0; message < batchSize; ++message) {
+                        myOutbox[message] = allocator.allocate();
+                        myOutbox[message]->words[0] = message;
+                        escape(myOutbox[message]);
+                    }
+                    if (sequence == 2) {
+                        roundBarrier->arrive_and_wait();
+                    }
+                    for(int message = 0; message < batchSize; ++message) {
+                        allocator.deallocate(inbox[message]);
+                    }
+                    if (sequence == 2) {
+                        roundBarrier->arrive_and_wait();
+                    }
+                }
+            });
+            if (t == 1) {
+                singleThreadSeconds = seconds;
+            }
+            uint64_t operations = 2 * static_cast<uint64_t>(t) * i;
+            std::cout << functionNames[sequence] << "\t" << operations << "\t" << t << "\t" << allocatorName << "\t"
+                      << sizeof(Message) << "\t" << operations/seconds << "\t"
+                      << scalingEfficiency(singleThreadSeconds, seconds) << "\t" << seconds << "\n";
+        }
+    }
+}
+
+/*
+ * runPoolBenchmark will allocate and free 64 byte messages with 1, 2, 4, ... up to t
+ * threads, through std::allocator<> and through an ObjectPool, in the sequences of
+ * timeMessages.  The final counter value counts allocations and frees, and scaling is
+ * the throughput over that of one thread times the number of threads, 1 being perfect
+ * scaling
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runPoolBenchmark(Arguments& arguments) {
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tAllocator\tObject Size\tOperations/Second\t"
+              << "Scaling\tSeconds\n";
+
+    StandardMessageAllocator standardAllocator;
+    timeMessages("std::allocator", standardAllocator, arguments);
+
+    ObjectPool pool(sizeof(Message));
+    PooledMessageAllocator pooledAllocator{pool};
+    timeMessages("objectPool", pooledAllocator, arguments);
+}
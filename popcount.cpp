@@ -0,0 +1,178 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <immintrin.h>                  // AVX2 and AVX-512 intrinsics
+#include "parcount.h"
+
+/*
+ * Each function below returns the number of set bits in words[0, n)
+ */
+typedef uint64_t (*PopcountFunction)(const uint64_t* words, std::size_t n);
+
+/*
+ * popcountPortable is built for the baseline instruction set, where the compiler
+ * expands __builtin_popcountll into shifts and masks.  popcountScalar is the same loop
+ * built to use the popcnt instruction
+ */
+static uint64_t popcountPortable(const uint64_t* words, std::size_t n) {
+    uint64_t count = 0;
+    for(std::size_t index = 0; index < n; ++index) {
+        count += __builtin_popcountll(words[index]);
+    }
+    return count;
+}
+
+__attribute__((target("popcnt")))
+static uint64_t popcountScalar(const uint64_t* words, std::size_t n) {
+    uint64_t count = 0;
+    for(std::size_t index = 0; index < n; ++index) {
+        count += __builtin_popcountll(words[index]);
+    }
+    return count;
+}
+
+/*
+ * popcountBytesAvx2 will count the bits of each byte of v with two 4 bit table lookups
+ * and sum them into the four 64 bit lanes
+ */
+__attribute__((target("avx2")))
+static inline __m256i popcountBytesAvx2(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_and_si256(v, lowNibbles);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+/*
+ * carrySaveAdd is a bitwise full adder over three vectors: high gets the carries and
+ * low the sums
+ */
+__attribute__((target("avx2")))
+static inline void carrySaveAdd(__m256i& high, __m256i& low, __m256i a, __m256i b, __m256i c) {
+    __m256i partial = _mm256_xor_si256(a, b);
+    high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(partial, c));
+    low = _mm256_xor_si256(partial, c);
+}
+
+/*
+ * popcountHarleySealAvx2 will feed 16 vectors at a time through a tree of carry-save
+ * adders, so only one vector in 16 (the sixteens) needs an actual population count.
+ * The ones, twos, fours and eights left over are counted once at the end
+ */
+__attribute__((target("avx2,popcnt")))
+static uint64_t popcountHarleySealAvx2(const uint64_t* words, std::size_t n) {
+    const __m256i* data = reinterpret_cast<const __m256i*>(words);
+    std::size_t vectors = n / 4;
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = _mm256_setzero_si256();
+    __m256i twos = _mm256_setzero_si256();
+    __m256i fours = _mm256_setzero_si256();
+    __m256i eights = _mm256_setzero_si256();
+    __m256i sixteens, twosA, twosB, foursA, foursB, eightsA, eightsB;
+
+    auto load = [data](std::size_t index) __attribute__((target("avx2"))) {
+        return _mm256_loadu_si256(data + index);
+    };
+    std::size_t index = 0;
+    for(; index + 16 <= vectors; index += 16) {
+        carrySaveAdd(twosA, ones, ones, load(index), load(index + 1));
+        carrySaveAdd(twosB, ones, ones, load(index + 2), load(index + 3));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, load(index + 4), load(index + 5));
+        carrySaveAdd(twosB, ones, ones, load(index + 6), load(index + 7));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsA, fours, fours, foursA, foursB);
+        carrySaveAdd(twosA, ones, ones, load(index + 8), load(index + 9));
+        carrySaveAdd(twosB, ones, ones, load(index + 10), load(index + 11));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, load(index + 12), load(index + 13));
+        carrySaveAdd(twosB, ones, ones, load(index + 14), load(index + 15));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsB, fours, fours, foursA, foursB);
+        carrySaveAdd(sixteens, eights, eights, eightsA, eightsB);
+        total = _mm256_add_epi64(total, popcountBytesAvx2(sixteens));
+    }
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcountBytesAvx2(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcountBytesAvx2(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcountBytesAvx2(twos), 1));
+    total = _mm256_add_epi64(total, popcountBytesAvx2(ones));
+    for(; index < vectors; ++index) {
+        total = _mm256_add_epi64(total, popcountBytesAvx2(load(index)));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + popcountScalar(words + vectors * 4, n - vectors * 4);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static uint64_t popcountAvx512(const uint64_t* words, std::size_t n) {
+    __m512i total = _mm512_setzero_si512();
+    std::size_t index = 0;
+    for(; index + 8 <= n; index += 8) {
+        total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_loadu_si512(words + index)));
+    }
+    return _mm512_reduce_add_epi64(total) + popcountScalar(words + index, n - index);
+}
+
+/*
+ * runPopcountBenchmark will count the set bits of an s MiB pseudorandom bitmap with
+ * per-thread slices, using portable __builtin_popcountll, then the popcnt instruction,
+ * the Harley-Seal AVX2 method and AVX-512 VPOPCNTQ as the processor supports them.  Each method runs at 1, 2, 4, ... threads up
+ * to t, and its speedup is relative to its own single thread run
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runPopcountBenchmark(Arguments& arguments) {
+    std::size_t n = (static_cast<std::size_t>(arguments.s) << 20) / sizeof(uint64_t);
+    std::vector<uint64_t> bitmap(n);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for(auto& word : bitmap) {
+        word = nextRandom(state);
+    }
+
+    struct NamedPopcount {
+        const char* name;
+        PopcountFunction popcount;
+    };
+    std::vector<NamedPopcount> popcounts = {{"scalar", popcountPortable}};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt")) {
+        popcounts.push_back(NamedPopcount{"scalarPopcnt", popcountScalar});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        popcounts.push_back(NamedPopcount{"harleySealAvx2", popcountHarleySealAvx2});
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+        popcounts.push_back(NamedPopcount{"vpopcntqAvx512", popcountAvx512});
+    }
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tBytes\tGB/Second\tSpeedup\tSeconds\n";
+    for(const NamedPopcount& namedPopcount : popcounts) {
+        double singleThreadSeconds = 0;
+        for(int t : doublingThreadCounts(arguments.t)) {
+            std::vector<PaddedCount> counts(t);
+            double seconds = runThreads(t, [&](int iterator) {
+                std::size_t begin = sliceBegin(n, t, iterator);
+                counts[iterator].count = namedPopcount.popcount(bitmap.data() + begin, sliceBegin(n, t, iterator + 1) - begin);
+            });
+            uint64_t total = 0;
+            for(auto& count : counts) {
+                total += count.count;
+            }
+            if (t == 1) {
+                singleThreadSeconds = seconds;
+            }
+            std::cout << namedPopcount.name << "\t" << total << "\t" << t << "\t" << n*sizeof(uint64_t) << "\t"
+                      << n*sizeof(uint64_t)/seconds/1e9 << "\t" << singleThreadSeconds/seconds << "\t"
+                      << seconds << "\n";
+        }
+    }
+}
@@ -0,0 +1,207 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <new>                          // placement new
+#include <mutex>                        // std::mutex
+#include <cstring>                      // strerror()
+#include <cerrno>                       // errno
+#include <pthread.h>                    // pthread_mutex_t and its process-shared attributes
+#include <unistd.h>                     // fork() and _exit()
+#include <sys/mman.h>                   // mmap() and munmap()
+#include <sys/wait.h>                   // waitpid()
+#include "parcount.h"
+
+/*
+ * SharedRegion is the state forked workers share through a MAP_SHARED mapping.  The
+ * atomics are lock-free and so address-free, which makes them work across processes
+ */
+struct SharedRegion {
+    alignas(cacheLineSize) std::atomic<int> ready{0};
+    alignas(cacheLineSize) std::atomic<bool> start{false};
+    alignas(cacheLineSize) int sharedCounter = 0;
+    alignas(cacheLineSize) std::atomic<int> sharedCounterAtomic{0};
+    alignas(cacheLineSize) pthread_mutex_t sharedMutex;
+    alignas(cacheLineSize) pthread_mutex_t robustMutex;
+};
+
+/*
+ * lockRobust will lock a robust mutex, making it consistent again if its previous owner
+ * died holding it
+ */
+static void lockRobust(pthread_mutex_t* mutex) {
+    if (pthread_mutex_lock(mutex) == EOWNERDEAD) {
+        pthread_mutex_consistent(mutex);
+    }
+}
+
+/*
+ * printProcessResult will print one line of results for a process or thread kernel
+ */
+static void printProcessResult(const char* functionName, int counter, int threads, int processes, double seconds) {
+    std::cout << functionName << "\t" << counter << "\t" << threads << "\t" << processes << "\t"
+              << counter/(seconds*1000.0) << "\t" << seconds << "\n";
+}
+
+/*
+ * runForked will fork t processes each running work(), wait until all of them are
+ * ready, then release them at once and wait for every one to exit.  A process that
+ * does not exit normally with status 0 is reported, since the shared counter it was
+ * incrementing is then short
+ *
+ * Input Arguments:
+ * region - pointer to the shared region the processes start from
+ * t - number of processes
+ * work - function each process runs before exiting
+ *
+ * Return Values:
+ * Seconds elapsed between releasing the processes and the last exit, or a negative
+ * value if fork() failed or a process failed
+ */
+static double runForked(SharedRegion* region, int t, const std::function<void()>& work) {
+    region->ready = 0;
+    region->start = false;
+    std::cout.flush();
+    std::vector<pid_t> children;
+    for(int process = 0; process < t; ++process) {
+        pid_t child = fork();
+        if (child == 0) {
+            region->ready.fetch_add(1);
+            while (!region->start.load());
+            work();
+            _exit(0);
+        }
+        if (child < 0) {
+            std::cerr << "fork: " << strerror(errno) << "\n";
+            region->start = true;
+            for(pid_t started : children) {
+                waitpid(started, nullptr, 0);
+            }
+            return -1;
+        }
+        children.push_back(child);
+    }
+    spinUntil([region, t]() { return region->ready.load() == t; });
+    int64_t t1 = nowNanoseconds();
+    region->start = true;
+    bool failed = false;
+    for(pid_t child : children) {
+        int status;
+        if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = true;
+        }
+    }
+    double seconds = (nowNanoseconds() - t1) / 1e9;
+    if (failed) {
+        std::cerr << "A forked process did not exit cleanly\n";
+        return -1;
+    }
+    return seconds;
+}
+
+/*
+ * runProcessCountBenchmark will increment a counter i times in each of t workers, first
+ * as threads and then as forked processes sharing a MAP_SHARED mapping:
+ *
+ * threadsAtomic - incrementiTimesAtomic
+ * threadsMutex - sharedCounter_mtx locked around every increment
+ * threadsProcessSharedMutex - a process-shared pthread mutex locked around every
+ *                             increment, from threads
+ * processesAtomic - a std::atomic<int> in the mapping fetch_added
+ * processesSharedMutex - a process-shared pthread mutex locked around every increment
+ * processesRobustMutex - a process-shared robust pthread mutex locked around every
+ *                        increment
+ *
+ * Locking around every increment, rather than once around all of them as
+ * incrementiTimesMutexLock does, is what makes the mutex the cost being measured.  Forking
+ * is not part of the time
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runProcessCountBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+
+    void* mapping = mmap(nullptr, sizeof(SharedRegion), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "mmap: " << strerror(errno) << "\n";
+        return;
+    }
+    SharedRegion* region = new (mapping) SharedRegion;
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&region->sharedMutex, &attributes);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&region->robustMutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tProcesses\tIncrements/Millisecond\tSeconds\n";
+
+    double seconds = runThreads(t, [&](int) {
+        int increments = i;
+        incrementiTimesAtomic(region->sharedCounterAtomic, increments);
+    });
+    printProcessResult("threadsAtomic", region->sharedCounterAtomic, t, 1, seconds);
+    region->sharedCounterAtomic = 0;
+
+    seconds = runThreads(t, [&](int) {
+        for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
+            std::lock_guard<std::mutex> lock(sharedCounter_mtx);
+            ++region->sharedCounter;
+        }
+    });
+    printProcessResult("threadsMutex", region->sharedCounter, t, 1, seconds);
+    region->sharedCounter = 0;
+
+    seconds = runThreads(t, [&](int) {
+        for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
+            pthread_mutex_lock(&region->sharedMutex);
+            ++region->sharedCounter;
+            pthread_mutex_unlock(&region->sharedMutex);
+        }
+    });
+    printProcessResult("threadsProcessSharedMutex", region->sharedCounter, t, 1, seconds);
+    region->sharedCounter = 0;
+
+    seconds = runForked(region, t, [&]() {
+        for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
+            region->sharedCounterAtomic.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    if (seconds >= 0) {
+        printProcessResult("processesAtomic", region->sharedCounterAtomic, 1, t, seconds);
+    }
+    region->sharedCounterAtomic = 0;
+
+    seconds = runForked(region, t, [&]() {
+        for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
+            pthread_mutex_lock(&region->sharedMutex);
+            ++region->sharedCounter;
+            pthread_mutex_unlock(&region->sharedMutex);
+        }
+    });
+    if (seconds >= 0) {
+        printProcessResult("processesSharedMutex", region->sharedCounter, 1, t, seconds);
+    }
+    region->sharedCounter = 0;
+
+    seconds = runForked(region, t, [&]() {
+        for(int incrementCounter = 0; incrementCounter < i; ++incrementCounter) {
+            lockRobust(&region->robustMutex);
+            ++region->sharedCounter;
+            pthread_mutex_unlock(&region->robustMutex);
+        }
+    });
+    if (seconds >= 0) {
+        printProcessResult("processesRobustMutex", region->sharedCounter, 1, t, seconds);
+    }
+    region->sharedCounter = 0;
+
+    pthread_mutex_destroy(&region->sharedMutex);
+    pthread_mutex_destroy(&region->robustMutex);
+    region->~SharedRegion();
+    munmap(mapping, sizeof(SharedRegion));
+}
@@ -0,0 +1,170 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <barrier>                      // std::barrier<>
+#include <immintrin.h>                  // SSE2 and AVX2 intrinsics
+#include "parcount.h"
+
+/*
+ * Each scan function writes the running sum of input[0, n), starting from carry, to
+ * output[0, n).  The inclusive scan of element j includes input[j], the exclusive scan
+ * does not.  Sums wrap modulo 2^32
+ */
+typedef void (*ScanFunction)(const uint32_t* input, uint32_t* output, std::size_t n, uint32_t carry, bool inclusive);
+
+static void scanScalar(const uint32_t* input, uint32_t* output, std::size_t n, uint32_t carry, bool inclusive) {
+    for(std::size_t index = 0; index < n; ++index) {
+        uint32_t value = input[index];
+        output[index] = inclusive ? carry + value : carry;
+        carry += value;
+    }
+}
+
+/*
+ * The vector scans add each register to itself shifted by one, then two elements, which
+ * leaves the prefix sums within each 128 bit lane.  AVX2 then adds the low lane's total
+ * to the high lane.  The carry is broadcast to every element and refreshed from the last
+ * element of each register
+ */
+__attribute__((target("sse2")))
+static void scanSse2(const uint32_t* input, uint32_t* output, std::size_t n, uint32_t carry, bool inclusive) {
+    __m128i carryVector = _mm_set1_epi32(carry);
+    std::size_t index = 0;
+    for(; index + 4 <= n; index += 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index));
+        __m128i sums = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+        sums = _mm_add_epi32(sums, _mm_slli_si128(sums, 8));
+        sums = _mm_add_epi32(sums, carryVector);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + index), inclusive ? sums : _mm_sub_epi32(sums, values));
+        carryVector = _mm_shuffle_epi32(sums, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    scanScalar(input + index, output + index, n - index, _mm_cvtsi128_si32(carryVector), inclusive);
+}
+
+__attribute__((target("avx2")))
+static void scanAvx2(const uint32_t* input, uint32_t* output, std::size_t n, uint32_t carry, bool inclusive) {
+    __m256i carryVector = _mm256_set1_epi32(carry);
+    const __m256i lastElement = _mm256_set1_epi32(7);
+    std::size_t index = 0;
+    for(; index + 8 <= n; index += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + index));
+        __m256i sums = _mm256_add_epi32(values, _mm256_slli_si256(values, 4));
+        sums = _mm256_add_epi32(sums, _mm256_slli_si256(sums, 8));
+        __m256i lowLaneTotal = _mm256_shuffle_epi32(sums, _MM_SHUFFLE(3, 3, 3, 3));
+        sums = _mm256_add_epi32(sums, _mm256_permute2x128_si256(lowLaneTotal, lowLaneTotal, 0x08));
+        sums = _mm256_add_epi32(sums, carryVector);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + index),
+                            inclusive ? sums : _mm256_sub_epi32(sums, values));
+        carryVector = _mm256_permutevar8x32_epi32(sums, lastElement);
+    }
+    scanScalar(input + index, output + index, n - index, _mm256_cvtsi256_si32(carryVector), inclusive);
+}
+
+/*
+ * sumBlock will return the sum of input[0, n) modulo 2^32.  It is simple enough for the
+ * compiler to vectorize at -O2
+ */
+static uint32_t sumBlock(const uint32_t* input, std::size_t n) {
+    uint32_t sum = 0;
+    for(std::size_t index = 0; index < n; ++index) {
+        sum += input[index];
+    }
+    return sum;
+}
+
+/*
+ * scanInParallel will scan input into output with t threads using two passes over t
+ * contiguous blocks.  The first pass sums every block, the block sums are scanned by
+ * the barrier's completion step once every thread has arrived, and the second pass
+ * scans every block starting from its offset.  Both passes run on the same threads
+ *
+ * Input Arguments:
+ * scan - function used for the in-block scan
+ * input - reference to the values to scan
+ * output - reference to the array receiving the scan
+ * t - number of threads
+ * inclusive - inclusive scan if true, exclusive otherwise
+ *
+ * Return Values:
+ * Seconds taken by both passes
+ */
+static double scanInParallel(ScanFunction scan, const std::vector<uint32_t>& input, std::vector<uint32_t>& output,
+                             int t, bool inclusive) {
+    std::size_t n = input.size();
+    std::vector<PaddedCount> blockSums(t);
+    auto scanBlockSums = [&]() noexcept {
+        uint32_t offset = 0;
+        for(auto& blockSum : blockSums) {
+            uint32_t sum = blockSum.count;
+            blockSum.count = offset;
+            offset += sum;
+        }
+    };
+    std::barrier passBarrier(t, scanBlockSums);
+
+    return runThreads(t, [&](int iterator) {
+        std::size_t begin = sliceBegin(n, t, iterator);
+        std::size_t size = sliceBegin(n, t, iterator + 1) - begin;
+        blockSums[iterator].count = sumBlock(input.data() + begin, size);
+        passBarrier.arrive_and_wait();
+        scan(input.data() + begin, output.data() + begin, size, blockSums[iterator].count, inclusive);
+    });
+}
+
+/*
+ * runScanBenchmark will scan an s MiB array of pseudorandom 32 bit integers, inclusive
+ * and exclusive, sequentially and with t threads using the scalar, SSE2 and AVX2
+ * in-block scans the processor supports.  Every parallel result is checked against the
+ * sequential one and its speedup over it is reported.  GB/Second counts every row by
+ * the input read and the output written, 2*n*4 bytes, so the rows compare directly
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runScanBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    std::size_t n = (static_cast<std::size_t>(arguments.s) << 20) / sizeof(uint32_t);
+
+    std::vector<uint32_t> input(n);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for(auto& value : input) {
+        value = nextRandom(state) >> 56;
+    }
+    std::vector<uint32_t> expected(n);
+    std::vector<uint32_t> output(n);
+
+    struct NamedScan {
+        const char* name;
+        ScanFunction scan;
+    };
+    std::vector<NamedScan> scans = {{"scalar", scanScalar}};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        scans.push_back(NamedScan{"sse2", scanSse2});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        scans.push_back(NamedScan{"avx2", scanAvx2});
+    }
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tInstruction Set\tElements\tGB/Second\t"
+              << "Speedup\tMatches Sequential\tSeconds\n";
+    const char* sequentialNames[] = {"sequentialExclusiveScan", "sequentialInclusiveScan"};
+    const char* parallelNames[] = {"parallelExclusiveScan", "parallelInclusiveScan"};
+    for(int inclusive = 0; inclusive < 2; ++inclusive) {
+        int64_t t1 = nowNanoseconds();
+        scanScalar(input.data(), expected.data(), n, 0, inclusive);
+        double sequentialSeconds = (nowNanoseconds() - t1) / 1e9;
+        std::cout << sequentialNames[inclusive] << "\t" << (n ? expected[n - 1] : 0) << "\t1\tscalar\t"
+                  << n << "\t" << 2*n*sizeof(uint32_t)/sequentialSeconds/1e9 << "\t1\tyes\t" << sequentialSeconds << "\n";
+
+        for(const NamedScan& namedScan : scans) {
+            double seconds = scanInParallel(namedScan.scan, input, output, t, inclusive);
+            std::cout << parallelNames[inclusive] << "\t" << (n ? output[n - 1] : 0) << "\t" << t << "\t"
+                      << namedScan.name << "\t" << n << "\t" << 2*n*sizeof(uint32_t)/seconds/1e9 << "\t"
+                      << sequentialSeconds/seconds << "\t" << (output == expected ? "yes" : "no") << "\t"
+                      << seconds << "\n";
+        }
+    }
+}
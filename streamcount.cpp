@@ -0,0 +1,558 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <deque>                        // std::deque<>
+#include <thread>                       // std::thread
+#include <mutex>                        // std::mutex and std::unique_lock<>
+#include <condition_variable>           // std::condition_variable
+#include <atomic>                       // std::atomic<int64_t>
+#include <functional>                   // std::function<>
+#include <algorithm>                    // std::min() and std::max()
+#include <optional>                     // std::optional<>
+#include <cerrno>                       // errno and EINTR
+#include <cstring>                      // strerror()
+#include <unistd.h>                     // read(), pread(), close() and syscall()
+#include <fcntl.h>                      // open() and posix_fadvise()
+#include <sys/mman.h>                   // mmap() and munmap()
+#include <sys/stat.h>                   // fstat()
+#include <sys/syscall.h>                // __NR_io_uring_setup, __NR_io_uring_enter and __NR_io_uring_register
+#include <sys/uio.h>                    // struct iovec
+#include <linux/io_uring.h>             // struct io_uring_params, io_uring_sqe and io_uring_cqe
+#include "parcount.h"
+
+const std::size_t chunkSize = 1 << 20;
+
+/*
+ * BlockingQueue is an unbounded queue whose pop() waits for an item and whose tryPop()
+ * does not
+ */
+template <typename T>
+class BlockingQueue {
+public:
+    void push(T item) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            items.push_back(item);
+        }
+        notEmpty.notify_one();
+    }
+
+    T pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        notEmpty.wait(lock, [this]() { return !items.empty(); });
+        T item = items.front();
+        items.pop_front();
+        return item;
+    }
+
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.front();
+        items.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mtx;
+    std::condition_variable notEmpty;
+    std::deque<T> items;
+};
+
+/*
+ * Chunk is one recycled read buffer, the number of bytes read into it, its position in
+ * the buffer pool and, for positioned reads, the file offset it was read from
+ */
+struct Chunk {
+    std::vector<uint8_t> bytes;
+    std::size_t size = 0;
+    int index = 0;
+    uint64_t offset = 0;
+};
+
+/*
+ * A ChunkReader fills chunks taken from freeChunks and passes them to filledChunks until
+ * its input ends, adding the time it spent waiting for a free chunk to stallNanoseconds.
+ * It returns 0, or the errno of the read that failed
+ */
+typedef std::function<int(std::vector<Chunk>& chunks, BlockingQueue<Chunk*>& freeChunks,
+                           BlockingQueue<Chunk*>& filledChunks, int64_t& stallNanoseconds)> ChunkReader;
+
+/*
+ * readChunks will fill chunks with read(2) calls on fd, one chunk at a time
+ */
+static int readChunks(int fd, BlockingQueue<Chunk*>& freeChunks, BlockingQueue<Chunk*>& filledChunks,
+                       int64_t& stallNanoseconds) {
+    bool endOfInput = false;
+    while (!endOfInput) {
+        int64_t waitStart = nowNanoseconds();
+        Chunk* chunk = freeChunks.pop();
+        stallNanoseconds += nowNanoseconds() - waitStart;
+        chunk->size = 0;
+        while (chunk->size < chunkSize) {
+            ssize_t bytesRead = read(fd, chunk->bytes.data() + chunk->size, chunkSize - chunk->size);
+            if (bytesRead < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytesRead < 0) {
+                return errno;
+            }
+            if (bytesRead == 0) {
+                endOfInput = true;
+                break;
+            }
+            chunk->size += bytesRead;
+        }
+        if (chunk->size > 0) {
+            filledChunks.push(chunk);
+        }
+        else {
+            freeChunks.push(chunk);
+        }
+    }
+    return 0;
+}
+
+/*
+ * IoUring is a minimal io_uring instance driven through the raw system calls, so no
+ * liburing is needed.  It has one submitter, the reader, so the submission tail and
+ * completion head are only ever written by that thread.  ready() is false when the
+ * kernel lacks io_uring or it is disabled
+ */
+class IoUring {
+public:
+    explicit IoUring(unsigned entries) {
+        io_uring_params params = {};
+        fd = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0) {
+            return;
+        }
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            cqRing = sqRing;
+        }
+        else {
+            cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqesMapping = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqesMapping != MAP_FAILED) {
+            sqes = static_cast<io_uring_sqe*>(sqesMapping);
+        }
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || !sqes) {
+            return;
+        }
+        char* sqBase = static_cast<char*>(sqRing);
+        char* cqBase = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sqBase + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sqBase + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sqBase + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cqBase + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cqBase + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cqBase + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+        isReady = true;
+    }
+
+    ~IoUring() {
+        if (sqes) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqRing && cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingSize);
+        }
+        if (sqRing && sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingSize);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool ready() const {
+        return isReady;
+    }
+
+    /*
+     * registerBuffers will pin chunks' buffers in the kernel so reads can use them as
+     * fixed buffers, identified by their chunk index
+     */
+    bool registerBuffers(std::vector<Chunk>& chunks) {
+        std::vector<iovec> iovecs(chunks.size());
+        for(std::size_t index = 0; index < chunks.size(); ++index) {
+            iovecs[index].iov_base = chunks[index].bytes.data();
+            iovecs[index].iov_len = chunks[index].bytes.size();
+        }
+        return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) == 0;
+    }
+
+    /*
+     * queueRead will add a read of length bytes at offset of fileDescriptor into chunk
+     * to the submission ring without entering the kernel
+     */
+    void queueRead(int fileDescriptor, Chunk* chunk, std::size_t length, uint64_t offset, bool fixedBuffer) {
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        *sqe = {};
+        sqe->opcode = fixedBuffer ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = fileDescriptor;
+        sqe->addr = reinterpret_cast<uint64_t>(chunk->bytes.data());
+        sqe->len = length;
+        sqe->off = offset;
+        sqe->buf_index = fixedBuffer ? chunk->index : 0;
+        sqe->user_data = reinterpret_cast<uint64_t>(chunk);
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++queued;
+    }
+
+    /*
+     * submitAndWait will submit every queued read and wait for at least one completion
+     */
+    bool submitAndWait() {
+        while (true) {
+            long submitted = syscall(__NR_io_uring_enter, fd, queued, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted >= 0) {
+                queued -= submitted;
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    /*
+     * waitForCompletions will wait, without submitting, until count completions are
+     * waiting in the ring
+     */
+    bool waitForCompletions(unsigned count) {
+        while (syscall(__NR_io_uring_enter, fd, 0, count, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * unsubmitted will return the number of queued reads not yet submitted to the kernel
+     */
+    unsigned unsubmitted() const {
+        return queued;
+    }
+
+    /*
+     * reap will call complete(chunk, result) for every completion waiting in the ring
+     */
+    template <typename Complete>
+    void reap(Complete complete) {
+        unsigned head = *cqHead;
+        while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            io_uring_cqe* cqe = &cqes[head & cqMask];
+            complete(reinterpret_cast<Chunk*>(cqe->user_data), cqe->res);
+            ++head;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    int fd = -1;
+    bool isReady = false;
+    unsigned queued = 0;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    std::size_t sqRingSize = 0;
+    std::size_t cqRingSize = 0;
+    std::size_t sqesSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+};
+
+/*
+ * readChunksIoUring will fill chunks from the regular file fd of size fileSize through
+ * ring, keeping a read outstanding for every chunk not held by a worker.  It only waits
+ * for a free chunk when no read is in flight.  A short read is finished with pread().
+ * After a failed read no more are queued, but those in flight are still drained.  If
+ * io_uring_enter() itself fails, the reads the kernel already holds are still writing
+ * into chunk buffers, so their completions are waited for before returning, unless
+ * that wait fails too
+ *
+ * Return Values:
+ * 0, or the errno of the read or io_uring_enter() that failed
+ */
+static int readChunksIoUring(IoUring& ring, bool fixedBuffers, int fd, uint64_t fileSize,
+                             BlockingQueue<Chunk*>& freeChunks, BlockingQueue<Chunk*>& filledChunks,
+                             int64_t& stallNanoseconds) {
+    uint64_t offset = 0;
+    int inFlight = 0;
+    int error = 0;
+    while ((!error && offset < fileSize) || inFlight > 0) {
+        while (!error && offset < fileSize) {
+            Chunk* chunk;
+            if (inFlight == 0) {
+                int64_t waitStart = nowNanoseconds();
+                chunk = freeChunks.pop();
+                stallNanoseconds += nowNanoseconds() - waitStart;
+            }
+            else if (!freeChunks.tryPop(chunk)) {
+                break;
+            }
+            chunk->size = std::min<uint64_t>(chunkSize, fileSize - offset);
+            ring.queueRead(fd, chunk, chunk->size, offset, fixedBuffers);
+            chunk->offset = offset;
+            offset += chunk->size;
+            ++inFlight;
+        }
+        if (!ring.submitAndWait()) {
+            error = errno;
+            int submitted = inFlight - ring.unsubmitted();
+            ring.reap([&](Chunk*, int) { --submitted; });
+            while (submitted > 0 && ring.waitForCompletions(submitted)) {
+                ring.reap([&](Chunk*, int) { --submitted; });
+            }
+            return error;
+        }
+        ring.reap([&](Chunk* chunk, int result) {
+            --inFlight;
+            std::size_t done = result < 0 ? 0 : result;
+            while (result >= 0 && done < chunk->size) {
+                ssize_t bytesRead = pread(fd, chunk->bytes.data() + done, chunk->size - done, chunk->offset + done);
+                if (bytesRead <= 0) {
+                    result = bytesRead < 0 ? -errno : -EIO;
+                    break;
+                }
+                done += bytesRead;
+            }
+            if (result < 0) {
+                if (!error) {
+                    error = -result;
+                }
+                freeChunks.push(chunk);
+                return;
+            }
+            filledChunks.push(chunk);
+        });
+    }
+    return error;
+}
+
+/*
+ * StreamCountResult holds what countStreamPipeline measured
+ */
+struct StreamCountResult {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+    double readerStallSeconds = 0;
+    double workerIdleSeconds = 0;
+    int error = 0;
+};
+
+/*
+ * countStreamPipeline will have reader fill a pool of 2*t chunk buffers on the calling
+ * thread, hand each filled chunk to one of t workers counting delimiter bytes, and
+ * recycle the chunk once counted.  The reader stalls when every buffer is waiting to be
+ * counted; workers idle when every buffer is waiting to be filled
+ *
+ * Input Arguments:
+ * reader - function that fills chunks from the input
+ * t - number of counting workers
+ * delimiter - byte to count
+ *
+ * Return Values:
+ * Delimiter count, bytes read, total time, reader stall time, summed worker idle time and
+ * the errno of a failed read, if any
+ */
+static StreamCountResult countStreamPipeline(const ChunkReader& reader, int t, uint8_t delimiter) {
+    StreamCountResult result;
+    ByteCounter counter = bestByteCounter();
+    BytePredicate predicate = {byteEquals, delimiter, delimiter};
+
+    std::vector<Chunk> chunks(2 * t);
+    BlockingQueue<Chunk*> freeChunks;
+    BlockingQueue<Chunk*> filledChunks;
+    for(std::size_t index = 0; index < chunks.size(); ++index) {
+        chunks[index].bytes.resize(chunkSize);
+        chunks[index].index = index;
+        freeChunks.push(&chunks[index]);
+    }
+
+    std::vector<PaddedCount> counts(t);
+    std::vector<PaddedCount> byteCounts(t);
+    std::atomic<int64_t> workerIdleNanoseconds{0};
+    int64_t readerStallNanoseconds = 0;
+
+    int64_t t1 = nowNanoseconds();
+    std::vector<std::thread> workers;
+    for(int iterator = 0; iterator < t; ++iterator) {
+        workers.push_back(std::thread([&, iterator]() {
+            int64_t idleNanoseconds = 0;
+            while (true) {
+                int64_t waitStart = nowNanoseconds();
+                Chunk* chunk = filledChunks.pop();
+                idleNanoseconds += nowNanoseconds() - waitStart;
+                if (!chunk) {
+                    break;
+                }
+                counts[iterator].count += counter.count(chunk->bytes.data(), chunk->size, predicate);
+                byteCounts[iterator].count += chunk->size;
+                freeChunks.push(chunk);
+            }
+            workerIdleNanoseconds += idleNanoseconds;
+        }));
+    }
+
+    // A null chunk tells each worker the input is done
+    result.error = reader(chunks, freeChunks, filledChunks, readerStallNanoseconds);
+    for(int iterator = 0; iterator < t; ++iterator) {
+        filledChunks.push(nullptr);
+    }
+    for(auto& worker : workers) {
+        worker.join();
+    }
+    result.seconds = (nowNanoseconds() - t1) / 1e9;
+
+    for(auto& count : counts) {
+        result.count += count.count;
+    }
+    for(auto& bytes : byteCounts) {
+        result.bytes += bytes.count;
+    }
+    result.readerStallSeconds = readerStallNanoseconds / 1e9;
+    result.workerIdleSeconds = workerIdleNanoseconds / 1e9;
+    return result;
+}
+
+/*
+ * runStreamCountBenchmark will count the delimiter bytes (newlines unless -d is given)
+ * of standard input with a reader thread feeding t counting workers
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runStreamCountBenchmark(Arguments& arguments) {
+    ChunkReader reader = [](std::vector<Chunk>&, BlockingQueue<Chunk*>& freeChunks,
+                            BlockingQueue<Chunk*>& filledChunks, int64_t& stallNanoseconds) {
+        return readChunks(STDIN_FILENO, freeChunks, filledChunks, stallNanoseconds);
+    };
+    StreamCountResult result = countStreamPipeline(reader, arguments.t, arguments.delimiter);
+    if (result.error) {
+        std::cerr << "standard input: " << strerror(result.error) << "\n";
+        return;
+    }
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tBytes\tGB/Second\tReader Stall Seconds\t"
+              << "Worker Idle Seconds\tSeconds\n";
+    std::cout << "countStreamDelimiters\t" << result.count << "\t" << arguments.t << "\t" << result.bytes << "\t"
+              << result.bytes/result.seconds/1e9 << "\t" << result.readerStallSeconds << "\t"
+              << result.workerIdleSeconds << "\t" << result.seconds << "\n";
+}
+
+/*
+ * runReadBackendBenchmark will count the delimiter bytes of the file named by --file
+ * with t workers, reading it with mmap(), with read(2) into the chunk pipeline, and with
+ * io_uring into the same pipeline using registered buffers and a read in flight for
+ * every free chunk.  io_uring falls back to read(2) when the kernel does not provide
+ * it.  Each backend runs once after asking the kernel to drop the file's cached pages
+ * and once with them cached
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runReadBackendBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int fd = open(arguments.file.c_str(), O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0) {
+        std::cerr << arguments.file << ": " << strerror(errno) << "\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    uint64_t fileSize = status.st_size;
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tBackend\tCache\tBytes\tGB/Second\t"
+              << "Reader Stall Seconds\tWorker Idle Seconds\tSeconds\n";
+
+    const char* cacheStates[] = {"cold", "warm"};
+    for(int cacheIterator = 0; cacheIterator < 2; ++cacheIterator) {
+        // Dropping only succeeds for clean pages, which is all a read-only scan leaves
+        const char* cacheState = cacheStates[cacheIterator];
+        bool cold = cacheIterator == 0;
+
+        if (cold) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+        std::size_t bytes;
+        std::string error;
+        int64_t t1 = nowNanoseconds();
+        uint64_t count = countMappedFile(arguments.file, t, arguments.delimiter, bestByteCounter(), bytes, error);
+        double seconds = (nowNanoseconds() - t1) / 1e9;
+        if (!error.empty()) {
+            std::cerr << arguments.file << ": " << error << "\n";
+        }
+        else {
+            std::cout << "countFileDelimiters\t" << count << "\t" << t << "\tmmap\t" << cacheState << "\t" << bytes
+                      << "\t" << bytes/seconds/1e9 << "\t0\t0\t" << seconds << "\n";
+        }
+
+        const char* backends[] = {"read", "ioUring"};
+        for(int backendIterator = 0; backendIterator < 2; ++backendIterator) {
+            bool useIoUring = backendIterator == 1;
+            const char* backendName = backends[backendIterator];
+            std::optional<IoUring> ring;
+            bool fixedBuffers = false;
+            if (useIoUring) {
+                ring.emplace(2 * t);
+                if (!ring->ready()) {
+                    backendName = "read (io_uring unavailable)";
+                    useIoUring = false;
+                }
+            }
+            if (cold) {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            }
+            lseek(fd, 0, SEEK_SET);
+            ChunkReader reader = [&](std::vector<Chunk>& chunks, BlockingQueue<Chunk*>& freeChunks,
+                                     BlockingQueue<Chunk*>& filledChunks, int64_t& stallNanoseconds) {
+                if (useIoUring) {
+                    fixedBuffers = ring->registerBuffers(chunks);
+                    return readChunksIoUring(*ring, fixedBuffers, fd, fileSize, freeChunks, filledChunks,
+                                             stallNanoseconds);
+                }
+                return readChunks(fd, freeChunks, filledChunks, stallNanoseconds);
+            };
+            StreamCountResult result = countStreamPipeline(reader, t, arguments.delimiter);
+            if (result.error) {
+                std::cerr << backendName << ": " << strerror(result.error) << "\n";
+                continue;
+            }
+            std::cout << "countFileDelimiters\t" << result.count << "\t" << t << "\t" << backendName
+                      << (fixedBuffers ? " (fixed buffers)" : "") << "\t" << cacheState << "\t" << result.bytes
+                      << "\t" << result.bytes/result.seconds/1e9 << "\t" << result.readerStallSeconds << "\t"
+                      << result.workerIdleSeconds << "\t" << result.seconds << "\n";
+        }
+    }
+    close(fd);
+}
@@ -0,0 +1,188 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <thread>                       // std::thread and std::jthread
+#include <algorithm>                    // std::max() and std::min()
+#include <pthread.h>                    // pthread_create() and pthread_attr_setstacksize()
+#include "parcount.h"
+
+/*
+ * ThreadTimes holds the nanosecond timestamps of one created thread: when its creator
+ * called the constructor, when the thread ran its first instruction, and when it ran
+ * its last
+ */
+struct ThreadTimes {
+    int64_t created;
+    int64_t started;
+    int64_t finished;
+};
+
+/*
+ * recordThreadTimes is the body of every created thread
+ */
+static void recordThreadTimes(ThreadTimes* times) {
+    times->started = nowNanoseconds();
+    times->finished = nowNanoseconds();
+}
+
+static void* recordThreadTimesPthread(void* times) {
+    recordThreadTimes(static_cast<ThreadTimes*>(times));
+    return nullptr;
+}
+
+/*
+ * StdThreadLauncher, JThreadLauncher and PthreadLauncher each create a batch of
+ * threads running recordThreadTimes and join them one at a time.  launch() returns
+ * false if the thread could not be created
+ */
+class StdThreadLauncher {
+public:
+    bool launch(ThreadTimes* times) {
+        threadVector.push_back(std::thread(recordThreadTimes, times));
+        return true;
+    }
+    void join(int iterator) {
+        threadVector[iterator].join();
+    }
+    void clear() {
+        threadVector.clear();
+    }
+
+private:
+    std::vector<std::thread> threadVector;
+};
+
+class JThreadLauncher {
+public:
+    bool launch(ThreadTimes* times) {
+        threadVector.push_back(std::jthread(recordThreadTimes, times));
+        return true;
+    }
+    void join(int iterator) {
+        threadVector[iterator].join();
+    }
+    void clear() {
+        threadVector.clear();
+    }
+
+private:
+    std::vector<std::jthread> threadVector;
+};
+
+class PthreadLauncher {
+public:
+    explicit PthreadLauncher(std::size_t stackBytes) {
+        pthread_attr_init(&attributes);
+        if (stackBytes != 0) {
+            pthread_attr_setstacksize(&attributes, stackBytes);
+        }
+    }
+    ~PthreadLauncher() {
+        pthread_attr_destroy(&attributes);
+    }
+    bool launch(ThreadTimes* times) {
+        pthread_t thread;
+        if (pthread_create(&thread, &attributes, recordThreadTimesPthread, times) != 0) {
+            return false;
+        }
+        threadVector.push_back(thread);
+        return true;
+    }
+    void join(int iterator) {
+        pthread_join(threadVector[iterator], nullptr);
+    }
+    void clear() {
+        threadVector.clear();
+    }
+
+private:
+    pthread_attr_t attributes;
+    std::vector<pthread_t> threadVector;
+};
+
+/*
+ * timeThreadCreation will create and join i threads in batches of t, as main() does
+ * for each counter kernel, and print start latency (constructor call to first
+ * instruction), join latency (later of the last instruction and the join call, to the
+ * join returning) and create/join throughput
+ *
+ * Input Arguments:
+ * functionName - name printed in the results
+ * stackKiB - stack size printed in the results, 0 for the default
+ * launcher - reference to the launcher under test
+ * t - threads per batch
+ * i - total number of threads to create
+ *
+ * Return Values:
+ * None
+ */
+template <typename Launcher>
+void timeThreadCreation(const char* functionName, std::size_t stackKiB, Launcher& launcher, int t, int i) {
+    std::vector<ThreadTimes> times(t);
+    std::vector<double> startLatencies;
+    std::vector<double> joinLatencies;
+    int created = 0;
+
+    int64_t t1 = nowNanoseconds();
+    while (created < i) {
+        int batch = std::min(t, i - created);
+        for(int iterator = 0; iterator < batch; ++iterator) {
+            times[iterator].created = nowNanoseconds();
+            if (!launcher.launch(&times[iterator])) {
+                batch = iterator;
+                break;
+            }
+        }
+        if (batch == 0) {
+            std::cerr << functionName << ": thread creation failed\n";
+            return;
+        }
+        for(int iterator = 0; iterator < batch; ++iterator) {
+            int64_t joinCalled = nowNanoseconds();
+            launcher.join(iterator);
+            int64_t joinReturned = nowNanoseconds();
+            startLatencies.push_back((times[iterator].started - times[iterator].created) / 1000.0);
+            joinLatencies.push_back((joinReturned - std::max(joinCalled, times[iterator].finished)) / 1000.0);
+        }
+        launcher.clear();
+        created += batch;
+    }
+    int64_t t2 = nowNanoseconds();
+    double seconds = (t2 - t1) / 1e9;
+
+    std::cout << functionName << "\t" << stackKiB << "\t" << i << "\t"
+              << percentile(startLatencies, 0.5) << "\t" << percentile(startLatencies, 0.99) << "\t"
+              << percentile(joinLatencies, 0.5) << "\t" << percentile(joinLatencies, 0.99) << "\t"
+              << i/seconds << "\t" << seconds << "\n";
+}
+
+/*
+ * runThreadCreateBenchmark will create and join i threads, t at a time, with
+ * std::thread, std::jthread, and pthread_create() at several stack sizes
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runThreadCreateBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+
+    std::cout << "Function Name\tStack Size (KiB)\tThreads Created\tMedian Start Latency (us)\t"
+              << "P99 Start Latency (us)\tMedian Join Latency (us)\tP99 Join Latency (us)\t"
+              << "Create+Join/Second\tSeconds\n";
+
+    StdThreadLauncher stdThreadLauncher;
+    timeThreadCreation("stdThread", 0, stdThreadLauncher, t, i);
+
+    JThreadLauncher jThreadLauncher;
+    timeThreadCreation("stdJThread", 0, jThreadLauncher, t, i);
+
+    // A stack size of 0 leaves the pthread default (normally RLIMIT_STACK) in place
+    const std::size_t stackSizesKiB[] = {0, 64, 256, 1024, 8192};
+    for(std::size_t stackKiB : stackSizesKiB) {
+        PthreadLauncher pthreadLauncher(stackKiB * 1024);
+        timeThreadCreation("pthreadCreate", stackKiB, pthreadLauncher, t, i);
+    }
+}
@@ -0,0 +1,252 @@
+#include <iostream>                     // std::cout
+#include <vector>                       // std::vector<>
+#include <deque>                        // std::deque<>
+#include <thread>                       // std::thread
+#include <mutex>                        // std::mutex and std::lock_guard<>
+#include <atomic>                       // std::atomic<long long> and fetch_add()
+#include <algorithm>                    // std::min()
+#include <functional>                   // std::function<>
+#include "parcount.h"
+
+typedef std::function<void()> Task;
+
+/*
+ * Index of the pool worker running on this thread, or -1 on threads outside the pool
+ */
+static thread_local int currentWorker = -1;
+
+/*
+ * WorkStealingPool gives every worker its own deque.  Tasks submitted from a worker go
+ * on the back of that worker's deque and the worker pops from the back, so recently
+ * spawned work stays hot in its cache.  An idle worker steals from the front of the
+ * other deques.  Tasks submitted from outside the pool are dealt round robin
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int t) : queues(t) {
+        for(int worker = 0; worker < t; ++worker) {
+            workers.push_back(std::thread(&WorkStealingPool::workerLoop, this, worker));
+        }
+    }
+
+    ~WorkStealingPool() {
+        stopping = true;
+        for(auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void submit(Task task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        int worker = currentWorker;
+        if (worker < 0) {
+            worker = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        }
+        std::lock_guard<std::mutex> lock(queues[worker].mtx);
+        queues[worker].tasks.push_back(std::move(task));
+    }
+
+    void waitIdle() {
+        spinUntil([this]() { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    long long steals() const {
+        return stealCount.load();
+    }
+
+private:
+    struct alignas(cacheLineSize) WorkerQueue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    bool popLocal(int worker, Task& task) {
+        std::lock_guard<std::mutex> lock(queues[worker].mtx);
+        if (queues[worker].tasks.empty()) {
+            return false;
+        }
+        task = std::move(queues[worker].tasks.back());
+        queues[worker].tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int worker, Task& task) {
+        int queueCount = queues.size();
+        for(int offset = 1; offset < queueCount; ++offset) {
+            WorkerQueue& victim = queues[(worker + offset) % queueCount];
+            std::lock_guard<std::mutex> lock(victim.mtx);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                stealCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int worker) {
+        currentWorker = worker;
+        Task task;
+        int idleCounter = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (popLocal(worker, task) || steal(worker, task)) {
+                task();
+                pending.fetch_sub(1, std::memory_order_release);
+                idleCounter = 0;
+            }
+            else if (++idleCounter % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::vector<WorkerQueue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<long long> pending{0};
+    std::atomic<long long> stealCount{0};
+    std::atomic<unsigned> nextQueue{0};
+    std::atomic<bool> stopping{false};
+};
+
+/*
+ * SharedQueuePool has every worker take tasks from the front of one deque behind one
+ * std::mutex
+ */
+class SharedQueuePool {
+public:
+    explicit SharedQueuePool(int t) {
+        for(int worker = 0; worker < t; ++worker) {
+            workers.push_back(std::thread(&SharedQueuePool::workerLoop, this));
+        }
+    }
+
+    ~SharedQueuePool() {
+        stopping = true;
+        for(auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void submit(Task task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.push_back(std::move(task));
+    }
+
+    void waitIdle() {
+        spinUntil([this]() { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    long long steals() const {
+        return 0;
+    }
+
+private:
+    bool pop(Task& task) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (tasks.empty()) {
+            return false;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        return true;
+    }
+
+    void workerLoop() {
+        Task task;
+        int idleCounter = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (pop(task)) {
+                task();
+                pending.fetch_sub(1, std::memory_order_release);
+                idleCounter = 0;
+            }
+            else if (++idleCounter % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::mutex mtx;
+    std::deque<Task> tasks;
+    std::vector<std::thread> workers;
+    std::atomic<long long> pending{0};
+    std::atomic<bool> stopping{false};
+};
+
+/*
+ * timeTaskDispatch will submit one root task to pool which in turn submits t*i
+ * increments as tasks of g increments, wait for all of them, and print throughput.
+ * Scheduling overhead per task is the worker time, over the cores actually available,
+ * not accounted for by running the same tasks back to back on one thread
+ *
+ * Input Arguments:
+ * functionName - name printed in the results
+ * pool - reference to the pool under test
+ * t - number of workers in pool
+ * i - increments per worker
+ * g - increments per task
+ * sequentialSeconds - time to run every task back to back on one thread
+ *
+ * Return Values:
+ * None
+ */
+template <typename Pool>
+void timeTaskDispatch(const char* functionName, Pool& pool, int t, int i, int g, double sequentialSeconds) {
+    long long totalIncrements = static_cast<long long>(t) * i;
+    long long tasks = (totalIncrements + g - 1) / g;
+    std::atomic<long long> counter{0};
+
+    int64_t t1 = nowNanoseconds();
+    pool.submit([&]() {
+        for(long long remaining = totalIncrements; remaining > 0; remaining -= g) {
+            int size = remaining < g ? static_cast<int>(remaining) : g;
+            pool.submit([&counter, size]() {
+                counter.fetch_add(incrementiTimesReturnCount(size), std::memory_order_relaxed);
+            });
+        }
+    });
+    pool.waitIdle();
+    double seconds = (nowNanoseconds() - t1) / 1e9;
+
+    int busyThreads = std::min<int>(t, std::max<std::size_t>(allowedCores().size(), 1));
+    std::cout << functionName << "\t" << counter << "\t" << t << "\t" << tasks << "\t" << g << "\t"
+              << tasks/seconds << "\t" << (seconds*busyThreads - sequentialSeconds)*1e6/tasks << "\t"
+              << pool.steals() << "\t" << seconds << "\n";
+}
+
+/*
+ * runThreadPoolBenchmark will dispatch t*i increments as tasks of g increments to a
+ * work-stealing pool and to a single shared queue pool, each with t workers
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runThreadPoolBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    int i = arguments.i;
+    int g = arguments.g < 1 ? 1 : arguments.g;
+
+    std::cout << "Function Name\tFinal Counter Value\tWorkers\tTasks\tIncrements/Task\tTasks/Second\t"
+              << "Overhead/Task (us)\tSteals\tSeconds\n";
+
+    int64_t t1 = nowNanoseconds();
+    long long counter = 0;
+    for(long long remaining = static_cast<long long>(t) * i; remaining > 0; remaining -= g) {
+        counter += incrementiTimesReturnCount(remaining < g ? static_cast<int>(remaining) : g);
+    }
+    double sequentialSeconds = (nowNanoseconds() - t1) / 1e9;
+
+    {
+        WorkStealingPool workStealingPool(t);
+        timeTaskDispatch("workStealingPool", workStealingPool, t, i, g, sequentialSeconds);
+    }
+    {
+        SharedQueuePool sharedQueuePool(t);
+        timeTaskDispatch("sharedQueuePool", sharedQueuePool, t, i, g, sequentialSeconds);
+    }
+}
@@ -0,0 +1,182 @@
+#include <iostream>                     // std::cout and std::cerr
+#include <vector>                       // std::vector<>
+#include <mutex>                        // std::mutex and std::lock_guard<>
+#include <optional>                     // std::optional<>
+#include <string_view>                  // std::string_view
+#include <unordered_map>                // std::unordered_map<>
+#include "parcount.h"
+
+/*
+ * WordHash hashes words with hashBytes
+ */
+struct WordHash {
+    std::size_t operator()(std::string_view word) const {
+        return hashBytes(reinterpret_cast<const uint8_t*>(word.data()), word.size());
+    }
+};
+
+/*
+ * WordCounts nodes come from ObjectPool so the private maps do not contend in malloc()
+ * while they grow
+ */
+typedef std::unordered_map<std::string_view, uint64_t, WordHash, std::equal_to<std::string_view>,
+                           PoolAllocator<std::pair<const std::string_view, uint64_t>>> WordCounts;
+
+/*
+ * wordPartition will return which of t partitions word belongs to.  It hashes only the
+ * length and the first and last bytes so that a word is not hashed in full twice
+ */
+static inline int wordPartition(std::string_view word, int t) {
+    uint64_t key = word.size() ^ static_cast<uint8_t>(word.front()) << 8 ^ static_cast<uint8_t>(word.back()) << 16;
+    return (mixHash(key) >> 32) * t >> 32;
+}
+
+/*
+ * isWordByte will return true for the ASCII letters and digits that make up words
+ */
+static inline bool isWordByte(uint8_t byte) {
+    return static_cast<uint8_t>((byte | 0x20) - 'a') < 26 || static_cast<uint8_t>(byte - '0') < 10;
+}
+
+/*
+ * visitWords will call visit with every maximal run of word bytes in [begin, end)
+ */
+template <typename Visit>
+static void visitWords(const char* begin, const char* end, Visit visit) {
+    const char* cursor = begin;
+    while (cursor < end) {
+        while (cursor < end && !isWordByte(*cursor)) {
+            ++cursor;
+        }
+        const char* word = cursor;
+        while (cursor < end && isWordByte(*cursor)) {
+            ++cursor;
+        }
+        if (cursor > word) {
+            visit(std::string_view(word, cursor - word));
+        }
+    }
+}
+
+/*
+ * generateCorpus will return about size bytes of text of Zipf distributed words from a
+ * vocabulary of k pseudorandom lower case words of 3 to 10 letters, twelve words to a
+ * line
+ */
+static std::string generateCorpus(std::size_t size, uint32_t k) {
+    std::vector<std::string> vocabulary(k);
+    for(uint32_t word = 0; word < k; ++word) {
+        uint64_t hash = mixHash(word);
+        std::size_t length = 3 + hash % 8;
+        for(std::size_t letter = 0; letter < length; ++letter) {
+            hash = mixHash(hash);
+            vocabulary[word].push_back('a' + hash % 26);
+        }
+    }
+    std::string corpus;
+    corpus.reserve(size + 16);
+    std::vector<uint32_t> words = generateZipfInput(size / 7, k, 1.0);
+    for(std::size_t index = 0; index < words.size() && corpus.size() < size; ++index) {
+        corpus += vocabulary[words[index]];
+        corpus += index % 12 == 11 ? '\n' : ' ';
+    }
+    return corpus;
+}
+
+/*
+ * printWordCountResult will print one line of results for a word counting kernel
+ */
+static void printWordCountResult(const char* functionName, uint64_t tokens, int t, std::size_t distinct,
+                                 std::size_t bytes, double mergeSeconds, double seconds) {
+    std::cout << functionName << "\t" << tokens << "\t" << t << "\t" << distinct << "\t" << bytes << "\t"
+              << tokens/seconds << "\t" << mergeSeconds << "\t" << seconds << "\n";
+}
+
+/*
+ * runWordCountBenchmark will count the frequency of every word of a text corpus with t
+ * threads, each tokenizing a record aligned slice, two ways:
+ *
+ * sharedLockedMap - every thread locks one shared map for every word
+ * privateMapsPartitionedMerge - every thread counts into its own maps, one per
+ *                               partition of the words, and once all are joined thread
+ *                               p merges partition p of every thread's maps
+ *
+ * The corpus is the file named by --file, or s MiB of generated text drawn from k words.
+ * Words are runs of ASCII letters and digits, and the maps key them by views into the
+ * corpus so counting does not copy them.  The final counter value is the number of
+ * tokens counted
+ *
+ * Input Arguments:
+ * arguments - parsed command line arguments
+ *
+ * Return Values:
+ * None
+ */
+void runWordCountBenchmark(Arguments& arguments) {
+    int t = arguments.t;
+    std::optional<MappedFile> file;
+    std::string generated;
+    const char* corpus;
+    std::size_t size;
+    if (!arguments.file.empty()) {
+        file.emplace(arguments.file);
+        if (!file->error.empty()) {
+            std::cerr << arguments.file << ": " << file->error << "\n";
+            return;
+        }
+        corpus = reinterpret_cast<const char*>(file->data);
+        size = file->size;
+    }
+    else {
+        generated = generateCorpus(static_cast<std::size_t>(arguments.s) << 20, arguments.k > 0 ? arguments.k : 1);
+        corpus = generated.data();
+        size = generated.size();
+    }
+    std::vector<std::size_t> boundaries =
+        recordAlignedSlices(reinterpret_cast<const uint8_t*>(corpus), size, t, arguments.delimiter);
+
+    std::cout << "Function Name\tFinal Counter Value\tThreads\tDistinct Words\tBytes\tTokens/Second\t"
+              << "Merge Seconds\tSeconds\n";
+
+    WordCounts sharedMap;
+    std::mutex sharedMapMutex;
+    double seconds = runThreads(t, [&](int iterator) {
+        visitWords(corpus + boundaries[iterator], corpus + boundaries[iterator + 1], [&](std::string_view word) {
+            std::lock_guard<std::mutex> lock(sharedMapMutex);
+            ++sharedMap[word];
+        });
+    });
+    uint64_t tokens = 0;
+    for(auto& entry : sharedMap) {
+        tokens += entry.second;
+    }
+    printWordCountResult("sharedLockedMap", tokens, t, sharedMap.size(), size, 0, seconds);
+
+    std::vector<std::vector<WordCounts>> privateMaps(t, std::vector<WordCounts>(t));
+    seconds = runThreads(t, [&](int iterator) {
+        std::vector<WordCounts>& myMaps = privateMaps[iterator];
+        visitWords(corpus + boundaries[iterator], corpus + boundaries[iterator + 1], [&](std::string_view word) {
+            ++myMaps[wordPartition(word, t)][word];
+        });
+    });
+    std::vector<WordCounts> mergedMaps(t);
+    double mergeSeconds = runThreads(t, [&](int partition) {
+        WordCounts& merged = mergedMaps[partition];
+        merged = std::move(privateMaps[0][partition]);
+        for(int iterator = 1; iterator < t; ++iterator) {
+            for(auto& entry : privateMaps[iterator][partition]) {
+                merged[entry.first] += entry.second;
+            }
+        }
+    });
+    tokens = 0;
+    std::size_t distinct = 0;
+    for(auto& merged : mergedMaps) {
+        distinct += merged.size();
+        for(auto& entry : merged) {
+            tokens += entry.second;
+        }
+    }
+    printWordCountResult("privateMapsPartitionedMerge", tokens, t, distinct, size, mergeSeconds,
+                         seconds + mergeSeconds);
+}